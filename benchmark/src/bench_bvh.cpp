@@ -0,0 +1,124 @@
+#include "bench_helpers.h"
+#include "utils/bvh.h"
+#include <benchmark/benchmark.h>
+#include <glm/glm.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Props scattered over a square kilometer, a few meters tall.
+constexpr auto scene_size = 500.0F;
+constexpr auto prop_size = 2.0F;
+
+std::vector<game_engine::aabb_t> build_boxes(size_t count, uint32_t seed = 42) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> positions(-scene_size, scene_size);
+    std::uniform_real_distribution<float> heights(0.0F, 10.0F);
+    std::uniform_real_distribution<float> sizes(0.2F, prop_size);
+
+    std::vector<game_engine::aabb_t> ret(count);
+    for (auto &box : ret) {
+        const glm::vec3 center(positions(generator), heights(generator), positions(generator));
+        box.m_min = center - glm::vec3(sizes(generator));
+        box.m_max = center + glm::vec3(sizes(generator));
+    }
+    return ret;
+}
+
+game_engine::bvh_t build_bvh(const std::vector<game_engine::aabb_t> &boxes) {
+    game_engine::bvh_t ret;
+    for (const auto &box : boxes) {
+        ret.insert(box);
+    }
+    ret.update();
+    return ret;
+}
+
+game_engine::frustum_t build_frustum() {
+    return game_engine::frustum_t(build_view_projection(glm::vec3(1.0F, 0.0F, -1.0F)));
+}
+
+void bm_bvh_build(benchmark::State &state) {
+    const auto boxes = build_boxes(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto bvh = build_bvh(boxes);
+        benchmark::DoNotOptimize(bvh.get_statistics());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Every object moves a little each frame, which refits without rebuilding.
+void bm_bvh_refit(benchmark::State &state) {
+    auto boxes = build_boxes(static_cast<size_t>(state.range(0)));
+    auto bvh = build_bvh(boxes);
+    float offset = 0.01F;
+    for (auto _ : state) {
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            boxes[i].m_min.y += offset;
+            boxes[i].m_max.y += offset;
+            bvh.move(i, boxes[i]);
+        }
+        bvh.update();
+        offset = -offset;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["rebuilds"] = static_cast<double>(bvh.get_statistics().m_rebuilds);
+}
+
+void bm_bvh_frustum_query(benchmark::State &state) {
+    const auto bvh = build_bvh(build_boxes(static_cast<size_t>(state.range(0))));
+    const auto frustum = build_frustum();
+    std::vector<uint32_t> result;
+    for (auto _ : state) {
+        result.clear();
+        bvh.query_frustum(frustum, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.counters["visible"] = static_cast<double>(result.size());
+}
+
+// What culling cost before the hierarchy: every box through the batch test.
+void bm_linear_frustum_query(benchmark::State &state) {
+    const auto boxes = build_boxes(static_cast<size_t>(state.range(0)));
+    const auto frustum = build_frustum();
+    std::vector<uint8_t> visible(boxes.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frustum.intersects(boxes.data(), boxes.size(), visible.data()));
+    }
+}
+
+void bm_bvh_ray_query(benchmark::State &state) {
+    const auto boxes = build_boxes(static_cast<size_t>(state.range(0)));
+    const auto bvh = build_bvh(boxes);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> directions(-1.0F, 1.0F);
+    for (auto _ : state) {
+        const glm::vec3 direction(directions(generator), directions(generator) * 0.1F, directions(generator));
+        const auto distance = bvh.query_ray(glm::vec3(0.0F, 2.0F, 0.0F), direction, 1e6F, [&](uint32_t handle) {
+            // Box hits stand in for the triangle tests of picking.
+            return glm::distance(glm::vec3(0.0F, 2.0F, 0.0F), boxes[handle].get_center());
+        });
+        benchmark::DoNotOptimize(distance);
+    }
+}
+
+void bm_bvh_sphere_query(benchmark::State &state) {
+    const auto bvh = build_bvh(build_boxes(static_cast<size_t>(state.range(0))));
+    std::vector<uint32_t> result;
+    for (auto _ : state) {
+        result.clear();
+        bvh.query_sphere(glm::vec3(0.0F, 2.0F, 0.0F), 20.0F, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.counters["overlapping"] = static_cast<double>(result.size());
+}
+
+} // namespace
+
+BENCHMARK(bm_bvh_build)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_bvh_refit)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_bvh_frustum_query)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_linear_frustum_query)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_bvh_ray_query)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_bvh_sphere_query)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Builds the view projection of a 16:9 camera standing two units above the ground, seeing from 0.1 to 100 units.
+ * @param front Direction the camera looks towards, kept level.
+ */
+inline glm::mat4 build_view_projection(const glm::vec3 &front) {
+    const auto projection = glm::perspective(glm::radians(45.0F), 16.0F / 9.0F, 0.1F, 100.0F);
+    const auto eye = glm::vec3(0.0F, 2.0F, 0.0F);
+    return projection * glm::lookAt(eye, eye + front, glm::vec3(0.0F, 1.0F, 0.0F));
+}
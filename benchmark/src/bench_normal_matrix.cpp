@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Vertex counts of the sphere and torus meshes, three vertices per triangle.
+constexpr auto sphere_vertices = 240;
+constexpr auto torus_vertices = 3456;
+
+glm::mat4 build_model() {
+    auto model = glm::mat4(1.0F);
+    model = glm::translate(model, glm::vec3(1.0F, 2.0F, 3.0F));
+    model = glm::rotate(model, glm::radians(30.0F), glm::vec3(0.0F, 1.0F, 0.0F));
+    model = glm::scale(model, glm::vec3(2.0F, 1.0F, 0.5F));
+    return model;
+}
+
+std::vector<glm::vec3> build_normals(size_t count) {
+    std::mt19937 generator(42); // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+    std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+
+    std::vector<glm::vec3> ret(count);
+    for (auto &normal : ret) {
+        normal = glm::normalize(glm::vec3(distribution(generator), distribution(generator), distribution(generator)));
+    }
+    return ret;
+}
+
+// What object.vert used to do: a full 4x4 inverse for every vertex.
+void bm_normal_inverse_per_vertex(benchmark::State &state) {
+    const auto model = build_model();
+    const auto normals = build_normals(static_cast<size_t>(state.range(0)));
+    std::vector<glm::vec3> out(normals.size());
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < normals.size(); ++i) {
+            out[i] = glm::mat3(glm::transpose(glm::inverse(model))) * normals[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The normal matrix computed once per draw, as shape_t does now.
+void bm_normal_matrix_per_draw(benchmark::State &state) {
+    const auto model = build_model();
+    const auto normals = build_normals(static_cast<size_t>(state.range(0)));
+    std::vector<glm::vec3> out(normals.size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(model);
+        const auto normal_matrix = glm::inverseTranspose(glm::mat3(model));
+        for (size_t i = 0; i < normals.size(); ++i) {
+            out[i] = normal_matrix * normals[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(bm_normal_inverse_per_vertex)->Arg(sphere_vertices)->Arg(torus_vertices);
+BENCHMARK(bm_normal_matrix_per_draw)->Arg(sphere_vertices)->Arg(torus_vertices);
@@ -0,0 +1,89 @@
+#include "bench_helpers.h"
+#include "utils/occlusion_buffer.h"
+#include <benchmark/benchmark.h>
+#include <glm/glm.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t buffer_width = 256;
+constexpr size_t buffer_height = 144;
+
+// Walls a few meters wide facing the camera, as two triangles each, like the occluders of an indoor scene.
+void build_walls(size_t count, std::vector<glm::vec3> &positions, std::vector<uint32_t> &indices) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> lateral(-20.0F, 20.0F);
+    std::uniform_real_distribution<float> depths(-40.0F, -5.0F);
+    std::uniform_real_distribution<float> sizes(1.0F, 4.0F);
+
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec3 center(lateral(generator), 2.0F, depths(generator));
+        const auto half_width = sizes(generator);
+        const auto half_height = sizes(generator);
+        const auto first = static_cast<uint32_t>(positions.size());
+        positions.emplace_back(center + glm::vec3(-half_width, -half_height, 0.0F));
+        positions.emplace_back(center + glm::vec3(half_width, -half_height, 0.0F));
+        positions.emplace_back(center + glm::vec3(half_width, half_height, 0.0F));
+        positions.emplace_back(center + glm::vec3(-half_width, half_height, 0.0F));
+        for (const auto offset : {0U, 1U, 2U, 0U, 2U, 3U}) {
+            indices.emplace_back(first + offset);
+        }
+    }
+}
+
+std::vector<game_engine::aabb_t> build_boxes(size_t count) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> lateral(-30.0F, 30.0F);
+    std::uniform_real_distribution<float> depths(-80.0F, -5.0F);
+    std::uniform_real_distribution<float> sizes(0.2F, 1.0F);
+
+    std::vector<game_engine::aabb_t> ret(count);
+    for (auto &box : ret) {
+        const glm::vec3 center(lateral(generator), 1.0F, depths(generator));
+        box.m_min = center - glm::vec3(sizes(generator));
+        box.m_max = center + glm::vec3(sizes(generator));
+    }
+    return ret;
+}
+
+void bm_occlusion_rasterize(benchmark::State &state) {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    build_walls(static_cast<size_t>(state.range(0)), positions, indices);
+    const auto view_projection = build_view_projection(glm::vec3(0.0F, 0.0F, -1.0F));
+
+    game_engine::occlusion_buffer_t buffer(buffer_width, buffer_height);
+    for (auto _ : state) {
+        buffer.clear();
+        buffer.rasterize(view_projection, positions.data(), indices.data(), indices.size());
+        benchmark::DoNotOptimize(buffer.get_depth(0, 0));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(indices.size() / 3));
+}
+
+void bm_occlusion_test(benchmark::State &state) {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    build_walls(64, positions, indices);
+    const auto boxes = build_boxes(static_cast<size_t>(state.range(0)));
+    const auto view_projection = build_view_projection(glm::vec3(0.0F, 0.0F, -1.0F));
+
+    game_engine::occlusion_buffer_t buffer(buffer_width, buffer_height);
+    buffer.rasterize(view_projection, positions.data(), indices.data(), indices.size());
+    size_t visible = 0;
+    for (auto _ : state) {
+        visible = 0;
+        for (const auto &box : boxes) {
+            visible += buffer.is_visible(box, view_projection) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(visible);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["visible"] = static_cast<double>(visible);
+}
+
+} // namespace
+
+BENCHMARK(bm_occlusion_rasterize)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_occlusion_test)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,127 @@
+#include "data_types/mesh.h"
+#include "utils/bvh.h"
+#include "utils/ray.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/glm.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// About a million triangles of terrain, split into as many tiles as there are instances.
+constexpr size_t scene_triangles = 1000000;
+constexpr auto scene_size = 80.0F;
+constexpr auto pick_max_distance = 1000.0F;
+
+/**
+ * @brief Builds a bumpy grid of two triangles per cell, spanning [-1, 1] on x and z, through a Wavefront object since
+ * that is the only way meshes are loaded.
+ */
+game_engine::mesh_t build_tile(size_t cells) {
+    const auto path = std::filesystem::temp_directory_path() / ("bench_pick_" + std::to_string(cells) + ".obj");
+    {
+        std::ofstream file(path);
+        file << "o tile\n";
+        for (size_t z = 0; z <= cells; ++z) {
+            for (size_t x = 0; x <= cells; ++x) {
+                const auto u = 2.0F * static_cast<float>(x) / static_cast<float>(cells) - 1.0F;
+                const auto v = 2.0F * static_cast<float>(z) / static_cast<float>(cells) - 1.0F;
+                file << "v " << u << ' ' << 0.05F * std::sin(u * 17.0F) * std::cos(v * 13.0F) << ' ' << v << '\n';
+            }
+        }
+        file << "vt 0.0 0.0\nvn 0.0 1.0 0.0\ns off\n";
+        for (size_t z = 0; z < cells; ++z) {
+            for (size_t x = 0; x < cells; ++x) {
+                // Wavefront indices start at one.
+                const auto first = z * (cells + 1) + x + 1;
+                const auto below = first + cells + 1;
+                file << "f " << first << "/1/1 " << below << "/1/1 " << first + 1 << "/1/1\n";
+                file << "f " << first + 1 << "/1/1 " << below << "/1/1 " << below + 1 << "/1/1\n";
+            }
+        }
+    }
+
+    game_engine::mesh_t ret(path);
+    std::filesystem::remove(path);
+    return ret;
+}
+
+/**
+ * @brief What shape_manager_t::pick() walks: a hierarchy over the shapes, each intersected in object space.
+ */
+struct scene_t {
+    game_engine::mesh_t m_tile;
+    std::vector<glm::mat4> m_models;
+    game_engine::bvh_t m_bvh;
+};
+
+scene_t build_scene(size_t instances) {
+    const auto tiles_per_side = static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(instances))));
+    const auto cells = static_cast<size_t>(std::sqrt(static_cast<double>(scene_triangles / instances) / 2.0));
+    const auto tile_size = scene_size / static_cast<float>(tiles_per_side);
+
+    scene_t ret{build_tile(cells), {}, {}};
+    for (size_t z = 0; z < tiles_per_side; ++z) {
+        for (size_t x = 0; x < tiles_per_side; ++x) {
+            const glm::vec3 center((static_cast<float>(x) + 0.5F) * tile_size - scene_size / 2.0F, 0.0F,
+                                   (static_cast<float>(z) + 0.5F) * tile_size - scene_size / 2.0F);
+            const auto model = glm::scale(glm::translate(glm::mat4(1.0F), center), glm::vec3(tile_size / 2.0F));
+            ret.m_models.emplace_back(model);
+            ret.m_bvh.insert(ret.m_tile.get_bounds().transform(model));
+        }
+    }
+    ret.m_bvh.update();
+    return ret;
+}
+
+// Clicks over the terrain, seen from above one of its edges.
+void bm_pick(benchmark::State &state) {
+    const auto scene = build_scene(static_cast<size_t>(state.range(0)));
+    const glm::vec3 eye(0.0F, 20.0F, scene_size);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> targets(-scene_size / 2.0F, scene_size / 2.0F);
+
+    size_t hits = 0;
+    for (auto _ : state) {
+        const game_engine::ray_t ray{eye, glm::vec3(targets(generator), 0.0F, targets(generator)) - eye};
+        auto max_distance = pick_max_distance;
+        const auto distance = scene.m_bvh.query_ray(ray.m_origin, ray.m_direction, max_distance, [&](uint32_t handle) {
+            // Same as shape_t::intersect(), inverse included.
+            const auto hit = scene.m_tile.intersect(ray.transform(glm::inverse(scene.m_models[handle])), max_distance);
+            if (hit >= 0.0F && hit <= max_distance) {
+                max_distance = hit;
+            }
+            return hit;
+        });
+        hits += distance >= 0.0F ? 1 : 0;
+        benchmark::DoNotOptimize(distance);
+    }
+    state.counters["triangles"] =
+        static_cast<double>(scene.m_tile.get_triangle_indices().size() / 3 * scene.m_models.size());
+    state.counters["hit_ratio"] = static_cast<double>(hits) / static_cast<double>(state.iterations());
+}
+
+// A single mesh of a million triangles, where only the triangle hierarchy helps.
+void bm_mesh_intersect(benchmark::State &state) {
+    const auto cells = static_cast<size_t>(std::sqrt(static_cast<double>(state.range(0)) / 2.0));
+    const auto tile = build_tile(cells);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> targets(-1.0F, 1.0F);
+    const glm::vec3 origin(0.0F, 1.0F, 2.0F);
+
+    for (auto _ : state) {
+        const game_engine::ray_t ray{origin, glm::vec3(targets(generator), 0.0F, targets(generator)) - origin};
+        benchmark::DoNotOptimize(tile.intersect(ray, pick_max_distance));
+    }
+    state.counters["triangles"] = static_cast<double>(tile.get_triangle_indices().size() / 3);
+}
+
+} // namespace
+
+BENCHMARK(bm_pick)->Arg(1)->Arg(64)->Arg(1024)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_mesh_intersect)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
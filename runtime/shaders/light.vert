@@ -3,11 +3,24 @@ layout (location = 0) in vec3 layout_pos;
 layout (location = 1) in vec2 layout_tex_coord;
 layout (location = 2) in vec3 layout_normals;
 
-uniform mat4 uniform_model;
-uniform mat4 uniform_view;
-uniform mat4 uniform_projection;
+// Per-instance attributes, mirrored in C++ by instance_t. Only the model matrix is used.
+layout (location = 3) in mat4 layout_model;
+
+struct depth_params_t {
+    float near;
+    float far;
+};
+
+// Shared by every stage, mirrored in C++ by the generated shaders::frame_block_t.
+layout (std140) uniform frame_block {
+    mat4 uniform_view;
+    mat4 uniform_projection;
+    mat4 uniform_view_projection;
+    vec3 uniform_view_pos;
+    depth_params_t uniform_depth;
+};
 
 void main()
 {
-    gl_Position = uniform_projection * uniform_view * uniform_model * vec4(layout_pos, 1.0);
+    gl_Position = uniform_view_projection * layout_model * vec4(layout_pos, 1.0);
 }
\ No newline at end of file
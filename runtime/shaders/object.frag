@@ -5,110 +5,157 @@
 #define LIGHT_DIRECTIONAL 2
 #define LIGHT_SPOT 3
 
-#define LIGHT_COUNT 10
+#define DIRECTIONAL_LIGHT_MAX 4
+// Texels of uniform_lights per light_t, each one holding a vec3 and the scalar that follows it.
+#define LIGHT_TEXELS 6
+
+// Variant features, defined by program_factory_t: DIFFUSE_MAP, SPECULAR_MAP, DEPTH_DEBUG, DEPTH_ENABLED, and
+// DIRECTIONAL_LIGHT_COUNT, the number of lights at the start of uniform_directional_light. Point and spot lights are
+// clustered instead: each fragment finds its cluster of the view frustum and evaluates the lights listed for it, or
+// those listed for its object if there are fewer.
 
 out vec4 frag_out_color;
 
 in vec2 vert_out_tex_coord;
 in vec3 vert_out_normals;
 in vec3 vert_out_position;
-
+// Ambient color and shininess.
+flat in vec4 vert_out_material;
+// Layer of texture2 and mix factor between texture1 and texture2.
+flat in vec2 vert_out_material_texture;
+// Offset in uniform_object_lights and light count of the object, the count saturated if the object has no list.
+flat in uvec2 vert_out_lights;
+
+// Members are ordered so every scalar fills the padding after a vec3 under std140, see the generated shaders::light_t.
 struct light_t {
-    int type;
     vec3 position;
+    int type;
     vec3 direction;
+    float cutoff_begin;
     vec3 ambient;
+    float cutoff_end;
     vec3 diffuse;
-    vec3 specular;
     float attenuation_constant;
+    vec3 specular;
     float attenuation_linear;
     float attenuation_quadratic;
-    float cutoff_begin;
-    float cutoff_end;
 };
 
+// Shared by every instance of a draw, the per-instance parameters come from the vertex shader.
 struct material_t {
-    vec3 ambient;
-    bool has_diffuse;
     sampler2D diffuse;
-    bool has_specular;
     sampler2D specular;
-    float shininess;
     sampler2D texture1;
-    sampler2D texture2;
-    float texture_mix;
+    sampler2DArray texture2;
+};
+
+// Froxel grid: screen tiles, split in depth slices spaced exponentially. See cluster_grid_t.
+struct cluster_params_t {
+    int tiles_x;
+    int tiles_y;
+    int slices;
+    float depth_scale;
+    float depth_bias;
 };
 
 struct depth_params_t {
-    bool debug;
-    bool enabled;
     float near;
     float far;
 };
 
-uniform vec3 uniform_view_pos;
+// Shared by every stage, mirrored in C++ by the generated shaders::frame_block_t.
+layout (std140) uniform frame_block {
+    mat4 uniform_view;
+    mat4 uniform_projection;
+    mat4 uniform_view_projection;
+    vec3 uniform_view_pos;
+    depth_params_t uniform_depth;
+};
+
 uniform material_t uniform_material;
-uniform light_t uniform_light[LIGHT_COUNT];
-uniform depth_params_t uniform_depth;
+layout (std140) uniform light_block {
+    light_t uniform_directional_light[DIRECTIONAL_LIGHT_MAX];
+    cluster_params_t uniform_cluster;
+};
 
+// Point and spot lights, LIGHT_TEXELS texels each.
+uniform samplerBuffer uniform_lights;
+// Offset in uniform_cluster_lights and light count of each cluster.
+uniform usamplerBuffer uniform_clusters;
+// Indices in uniform_lights.
+uniform usamplerBuffer uniform_cluster_lights;
+uniform usamplerBuffer uniform_object_lights;
+
+vec3 build_light(light_t light, vec3 normals, vec3 light_direction, float intensity);
 vec3 build_light_ambient(light_t light, float attenuation);
 vec3 build_light_diffuse(light_t light, vec3 normals, vec3 light_direction, float attenuation);
 vec3 build_light_specular(light_t light, vec3 normals, vec3 light_direction, float attenuation);
 
-vec3 calculate_light_direction(light_t light);
 float calculate_attenuation(light_t light);
-float calculate_light_intensity(light_t light, vec3 light_direction);
+float calculate_spot_intensity(light_t light, vec3 light_direction);
+
+light_t fetch_light(int index);
+int find_cluster();
 
 float linearize_depth(float depth);
 
 void main()
 {
+#ifdef DEPTH_DEBUG
+    float d = linearize_depth(gl_FragCoord.z);
+    frag_out_color = vec4(vec3(d), 1.0);
+#else
     vec4 object_color = mix(texture(uniform_material.texture1, vert_out_tex_coord),
-                            texture(uniform_material.texture2, vert_out_tex_coord),
-                            uniform_material.texture_mix);
+                            texture(uniform_material.texture2, vec3(vert_out_tex_coord, vert_out_material_texture.x)),
+                            vert_out_material_texture.y);
 
+    vec3 normals = normalize(vert_out_normals);
     vec3 result = vec3(0.0);
 
-    if (!uniform_depth.debug) {
-        for (int i = 0; i < LIGHT_COUNT; i++) {
-            if (uniform_light[i].type == LIGHT_DEACTIVATED) {
-                continue;
-            }
-
-            vec3 light_direction = calculate_light_direction(uniform_light[i]);
-            float light_intensity = calculate_light_intensity(uniform_light[i], light_direction);
-
-            if (light_intensity > 0.0) {
-                vec3 normals = normalize(vert_out_normals);
-                float light_attenuation = calculate_attenuation(uniform_light[i]) * light_intensity;
-                vec3 ambient_light = build_light_ambient(uniform_light[i], light_attenuation);
-                vec3 diffuse_light = build_light_diffuse(uniform_light[i], normals, light_direction, light_attenuation);
-                vec3 specular_light = build_light_specular(uniform_light[i], normals, light_direction, light_attenuation);
-                result += ambient_light + diffuse_light + specular_light;
-            }
-        }
-
-        if (uniform_depth.enabled) {
-            result *= linearize_depth(gl_FragCoord.z);
-        }
-
-        frag_out_color = vec4(result, 1.0) * object_color;
-    } else {
-        float d = linearize_depth(gl_FragCoord.z);
-        frag_out_color = vec4(vec3(d), 1.0);
+    for (int i = 0; i < DIRECTIONAL_LIGHT_COUNT; i++) {
+        light_t light = uniform_directional_light[i];
+        result += build_light(light, normals, normalize(-light.direction), 1.0);
     }
+
+    // Both lists hold every light reaching the fragment, the shorter one is cheaper to walk.
+    uvec2 cluster = texelFetch(uniform_clusters, find_cluster()).rg;
+    bool object_list = vert_out_lights.y < cluster.y;
+    uvec2 range = object_list ? vert_out_lights : cluster;
+    for (uint i = 0u; i < range.y; i++) {
+        int entry = int(range.x + i);
+        uint index = object_list ? texelFetch(uniform_object_lights, entry).r
+                                 : texelFetch(uniform_cluster_lights, entry).r;
+        light_t light = fetch_light(int(index));
+        vec3 light_direction = normalize(light.position - vert_out_position);
+        float intensity = LIGHT_SPOT == light.type ? calculate_spot_intensity(light, light_direction) : 1.0;
+        result += build_light(light, normals, light_direction, intensity);
+    }
+
+#ifdef DEPTH_ENABLED
+    result *= linearize_depth(gl_FragCoord.z);
+#endif
+
+    frag_out_color = vec4(result, 1.0) * object_color;
+#endif
+}
+
+vec3 build_light(light_t light, vec3 normals, vec3 light_direction, float intensity) {
+    float attenuation = calculate_attenuation(light) * intensity;
+    return build_light_ambient(light, attenuation) +
+           build_light_diffuse(light, normals, light_direction, attenuation) +
+           build_light_specular(light, normals, light_direction, attenuation);
 }
 
 vec3 build_light_ambient(light_t light, float attenuation) {
-    return light.ambient * uniform_material.ambient * attenuation;
+    return light.ambient * vert_out_material.rgb * attenuation;
 }
 
 vec3 build_light_diffuse(light_t light, vec3 normals, vec3 light_direction, float attenuation) {
     float absolute = max(dot(normals, light_direction), 0.0);
     vec3 ret = light.diffuse * absolute;
-    if (uniform_material.has_diffuse) {
-        ret *= vec3(texture(uniform_material.diffuse, vert_out_tex_coord));
-    }
+#ifdef DIFFUSE_MAP
+    ret *= vec3(texture(uniform_material.diffuse, vert_out_tex_coord));
+#endif
     return ret * attenuation;
 }
 
@@ -116,21 +163,14 @@ vec3 build_light_specular(light_t light, vec3 normals, vec3 light_direction, flo
     vec3 view_direction = normalize(uniform_view_pos - vert_out_position);
     vec3 reflect_direction = reflect(-light_direction, normals);
 
-    float absolute = pow(max(dot(view_direction, reflect_direction), 0.0), uniform_material.shininess);
+    float absolute = pow(max(dot(view_direction, reflect_direction), 0.0), vert_out_material.a);
     vec3 ret = light.specular * absolute;
-    if (uniform_material.has_specular) {
-        ret *= vec3(texture(uniform_material.specular, vert_out_tex_coord));
-    }
+#ifdef SPECULAR_MAP
+    ret *= vec3(texture(uniform_material.specular, vert_out_tex_coord));
+#endif
     return ret * attenuation;
 }
 
-vec3 calculate_light_direction(light_t light) {
-    if (light.type == LIGHT_DIRECTIONAL) {
-        return normalize(-light.direction);
-    }
-    return normalize(light.position - vert_out_position);
-}
-
 float calculate_attenuation(light_t light) {
     float distance = length(light.position - vert_out_position);
     return 1.0 / (light.attenuation_constant +
@@ -138,16 +178,48 @@ float calculate_attenuation(light_t light) {
                   light.attenuation_quadratic * (distance * distance));
 }
 
-float calculate_light_intensity(light_t light, vec3 direction) {
-    if (light.type != LIGHT_SPOT) {
-        return 1.0;
-    }
-
+float calculate_spot_intensity(light_t light, vec3 direction) {
     float light_angle = dot(direction, normalize(-light.direction));
     float smooth_cutoff = light.cutoff_begin - light.cutoff_end;
     return clamp((light_angle - light.cutoff_end) / smooth_cutoff, 0.0, 1.0);
 }
 
+light_t fetch_light(int index) {
+    int base = index * LIGHT_TEXELS;
+    vec4 texel0 = texelFetch(uniform_lights, base);
+    vec4 texel1 = texelFetch(uniform_lights, base + 1);
+    vec4 texel2 = texelFetch(uniform_lights, base + 2);
+    vec4 texel3 = texelFetch(uniform_lights, base + 3);
+    vec4 texel4 = texelFetch(uniform_lights, base + 4);
+    vec4 texel5 = texelFetch(uniform_lights, base + 5);
+
+    light_t ret;
+    ret.position = texel0.xyz;
+    ret.type = int(texel0.w + 0.5);
+    ret.direction = texel1.xyz;
+    ret.cutoff_begin = texel1.w;
+    ret.ambient = texel2.xyz;
+    ret.cutoff_end = texel2.w;
+    ret.diffuse = texel3.xyz;
+    ret.attenuation_constant = texel3.w;
+    ret.specular = texel4.xyz;
+    ret.attenuation_linear = texel4.w;
+    ret.attenuation_quadratic = texel5.x;
+    return ret;
+}
+
+int find_cluster() {
+    vec4 clip = uniform_view_projection * vec4(vert_out_position, 1.0);
+    vec2 screen = clamp(clip.xy / clip.w * 0.5 + 0.5, 0.0, 0.999999);
+    float depth = -(uniform_view * vec4(vert_out_position, 1.0)).z;
+
+    int x = int(screen.x * float(uniform_cluster.tiles_x));
+    int y = int(screen.y * float(uniform_cluster.tiles_y));
+    int slice = clamp(int(log(max(depth, 1e-6)) * uniform_cluster.depth_scale - uniform_cluster.depth_bias), 0,
+                      uniform_cluster.slices - 1);
+    return (slice * uniform_cluster.tiles_y + y) * uniform_cluster.tiles_x + x;
+}
+
 float linearize_depth(float d) {
     float n = uniform_depth.near;
     float f = uniform_depth.far;
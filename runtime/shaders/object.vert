@@ -3,18 +3,42 @@ layout (location = 0) in vec3 layout_pos;
 layout (location = 1) in vec2 layout_tex_coord;
 layout (location = 2) in vec3 layout_normals;
 
+// Per-instance attributes, mirrored in C++ by instance_t.
+layout (location = 3) in mat4 layout_model;
+layout (location = 7) in mat3 layout_normal_matrix;
+layout (location = 10) in vec4 layout_material;
+layout (location = 11) in vec2 layout_material_texture;
+// Offset in uniform_object_lights and light count.
+layout (location = 12) in uvec2 layout_lights;
+
 out vec2 vert_out_tex_coord;
 out vec3 vert_out_normals;
 out vec3 vert_out_position;
+flat out vec4 vert_out_material;
+flat out vec2 vert_out_material_texture;
+flat out uvec2 vert_out_lights;
+
+struct depth_params_t {
+    float near;
+    float far;
+};
 
-uniform mat4 uniform_model;
-uniform mat4 uniform_view;
-uniform mat4 uniform_projection;
+// Shared by every stage, mirrored in C++ by the generated shaders::frame_block_t.
+layout (std140) uniform frame_block {
+    mat4 uniform_view;
+    mat4 uniform_projection;
+    mat4 uniform_view_projection;
+    vec3 uniform_view_pos;
+    depth_params_t uniform_depth;
+};
 
 void main()
 {
-    gl_Position = uniform_projection * uniform_view * uniform_model * vec4(layout_pos, 1.0);
+    gl_Position = uniform_view_projection * layout_model * vec4(layout_pos, 1.0);
     vert_out_tex_coord = layout_tex_coord;
-    vert_out_normals = mat3(transpose(inverse(uniform_model))) * layout_normals;
-    vert_out_position = vec3(uniform_model * vec4(layout_pos, 1.0));
+    vert_out_normals = layout_normal_matrix * layout_normals;
+    vert_out_position = vec3(layout_model * vec4(layout_pos, 1.0));
+    vert_out_material = layout_material;
+    vert_out_material_texture = layout_material_texture;
+    vert_out_lights = layout_lights;
 }
\ No newline at end of file
@@ -44,4 +44,15 @@ void camera_t::set_front(double pitch, double yaw) {
     m_front = glm::normalize(direction);
 }
 
+ray_t camera_t::get_ray(const glm::mat4 &projection, const glm::vec2 &ndc) const {
+    const auto inverse = glm::inverse(projection * glm::lookAt(m_position, m_position + m_front, m_up));
+    const auto near_point = inverse * glm::vec4(ndc.x, ndc.y, -1.0F, 1.0F);
+    const auto far_point = inverse * glm::vec4(ndc.x, ndc.y, 1.0F, 1.0F);
+
+    ray_t ret;
+    ret.m_origin = glm::vec3(near_point) / near_point.w;
+    ret.m_direction = glm::vec3(far_point) / far_point.w - ret.m_origin;
+    return ret;
+}
+
 } // namespace game_engine
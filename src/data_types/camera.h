@@ -1,5 +1,6 @@
 #pragma once
 
+#include "utils/ray.h"
 #include <glm/glm.hpp>
 
 namespace game_engine {
@@ -19,6 +20,14 @@ class camera_t {
 
     void set_front(double pitch, double yaw);
 
+    /**
+     * @brief Builds the world-space ray under a point of the viewport, from the near to the far clipping plane.
+     * @param projection Projection matrix the view is rendered with.
+     * @param ndc Point in normalized device coordinates.
+     * @return Ray starting on the near plane, whose direction reaches the far plane at distance 1.
+     */
+    [[nodiscard]] ray_t get_ray(const glm::mat4 &projection, const glm::vec2 &ndc) const;
+
   private:
     glm::vec3 m_position;
     glm::vec3 m_up;
@@ -1,22 +1,112 @@
 #include "image.h"
 
+#include "utils/buffer_pool.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// Pool stb allocates from while decoding on this thread, or nullptr to use the system allocator.
+thread_local game_engine::buffer_pool_t *t_decode_pool = nullptr; // NOLINT(*-non-const-global-variables)
+
+void *decode_malloc(size_t size) {
+    return nullptr == t_decode_pool ? std::malloc(size) : t_decode_pool->allocate(size);
+}
+
+void *decode_realloc(void *block, size_t size) {
+    return nullptr == t_decode_pool ? std::realloc(block, size) : t_decode_pool->reallocate(block, size);
+}
+
+void decode_free(void *block) {
+    if (nullptr == t_decode_pool) {
+        std::free(block);
+    } else {
+        t_decode_pool->deallocate(block);
+    }
+}
+
+class decode_pool_scope_t {
+  public:
+    explicit decode_pool_scope_t(game_engine::buffer_pool_t *pool) : m_previous(t_decode_pool) {
+        t_decode_pool = pool;
+    }
+    ~decode_pool_scope_t() {
+        t_decode_pool = m_previous;
+    }
+    decode_pool_scope_t(const decode_pool_scope_t &) = delete;
+    decode_pool_scope_t(decode_pool_scope_t &&) = delete;
+    decode_pool_scope_t &operator=(const decode_pool_scope_t &) = delete;
+    decode_pool_scope_t &operator=(decode_pool_scope_t &&) = delete;
+
+  private:
+    game_engine::buffer_pool_t *m_previous;
+};
+
+} // namespace
+
+#define STBI_MALLOC(size) decode_malloc(size)
+#define STBI_REALLOC(block, size) decode_realloc(block, size)
+#define STBI_FREE(block) decode_free(block)
 #define STB_IMAGE_IMPLEMENTATION
 
 #include "stb_image.h"
 #include "utils/exception.h"
+#include "utils/pixel_kernels.h"
 
 namespace game_engine {
 
-image_t::image_t(const std::filesystem::path &path) {
-    stbi_set_flip_vertically_on_load(1);
-    m_data = stbi_load(path.c_str(), &m_width, &m_height, &m_num_channels, 0);
+namespace {
+
+constexpr auto rgb_channels = 3;
+constexpr auto rgba_channels = 4;
+
+} // namespace
+
+image_t::image_t(const std::filesystem::path &path, const image_options_t &options)
+    : m_buffer_pool(options.m_buffer_pool) {
+
+    // Both the decoder scratch memory and the returned pixels come from the pool, when there is one.
+    const decode_pool_scope_t decode_pool_scope(m_buffer_pool);
+
+    int channels_in_file{};
+    if (0 == stbi_info(path.c_str(), &m_width, &m_height, &channels_in_file)) {
+        throw exception_t("failed to open image: " + path.string());
+    }
+
+    // RGB images are expanded by our vectorized kernel, stb only gets to convert the rarer grey formats.
+    const auto requested_channels = rgb_channels == channels_in_file ? 0 : rgba_channels;
+    m_data = stbi_load(path.c_str(), &m_width, &m_height, &m_num_channels, requested_channels);
     if (nullptr == m_data) {
         throw exception_t("failed to open image: " + path.string());
     }
+
+    const auto pixel_count = static_cast<size_t>(m_width) * m_height;
+    if (rgb_channels == m_num_channels) {
+        auto *rgba = static_cast<unsigned char *>(decode_malloc(pixel_count * rgba_channels));
+        if (nullptr == rgba) {
+            stbi_image_free(m_data);
+            throw exception_t("failed to allocate image: " + path.string());
+        }
+        expand_rgb_to_rgba(m_data, rgba, pixel_count);
+        stbi_image_free(m_data);
+        m_data = rgba;
+    }
+    m_num_channels = rgba_channels;
+
+    if (options.m_flip_vertically) {
+        flip_vertically(m_data, static_cast<size_t>(m_width) * rgba_channels, m_height);
+    }
+    if (options.m_srgb_to_linear) {
+        srgb_to_linear(m_data, pixel_count);
+    }
+    if (options.m_premultiply_alpha) {
+        premultiply_alpha(m_data, pixel_count);
+    }
 }
 
 image_t::image_t(image_t &&other) noexcept
-    : m_width(other.m_width), m_height(other.m_height), m_num_channels(other.m_num_channels), m_data(other.m_data) {
+    : m_width(other.m_width), m_height(other.m_height), m_num_channels(other.m_num_channels), m_data(other.m_data),
+      m_buffer_pool(other.m_buffer_pool) {
 
     other.m_width = 0;
     other.m_height = 0;
@@ -25,21 +115,16 @@ image_t::image_t(image_t &&other) noexcept
 }
 
 image_t::~image_t() {
+    const decode_pool_scope_t decode_pool_scope(m_buffer_pool);
     stbi_image_free(m_data);
 }
 
 image_t &image_t::operator=(image_t &&other) noexcept {
-    m_width = other.m_width;
-    other.m_width = 0;
-
-    m_height = other.m_height;
-    other.m_height = 0;
-
-    m_num_channels = other.m_num_channels;
-    other.m_num_channels = 0;
-
-    m_data = other.m_data;
-    other.m_data = nullptr;
+    std::swap(m_width, other.m_width);
+    std::swap(m_height, other.m_height);
+    std::swap(m_num_channels, other.m_num_channels);
+    std::swap(m_data, other.m_data);
+    std::swap(m_buffer_pool, other.m_buffer_pool);
     return *this;
 }
 
@@ -58,4 +143,42 @@ const unsigned char *image_t::get_data() const {
 bool image_t::has_alpha() const {
     return m_num_channels == 4;
 }
+
+int image_t::get_num_channels() const {
+    return m_num_channels;
+}
+
+image_t image_t::downsample() const {
+    image_t ret;
+    ret.m_width = std::max(1, m_width / 2);
+    ret.m_height = std::max(1, m_height / 2);
+    ret.m_num_channels = m_num_channels;
+    ret.m_buffer_pool = m_buffer_pool;
+
+    const decode_pool_scope_t decode_pool_scope(m_buffer_pool);
+    const auto bytes = static_cast<size_t>(ret.m_width) * ret.m_height * m_num_channels;
+    ret.m_data = static_cast<unsigned char *>(decode_malloc(bytes));
+    if (nullptr == ret.m_data) {
+        throw exception_t("failed to allocate image mip level");
+    }
+
+    for (int y = 0; y < ret.m_height; ++y) {
+        const auto y0 = std::min(y * 2, m_height - 1);
+        const auto y1 = std::min(y * 2 + 1, m_height - 1);
+        for (int x = 0; x < ret.m_width; ++x) {
+            const auto x0 = std::min(x * 2, m_width - 1);
+            const auto x1 = std::min(x * 2 + 1, m_width - 1);
+            for (int c = 0; c < m_num_channels; ++c) {
+                const auto sum = m_data[(y0 * m_width + x0) * m_num_channels + c] +
+                                 m_data[(y0 * m_width + x1) * m_num_channels + c] +
+                                 m_data[(y1 * m_width + x0) * m_num_channels + c] +
+                                 m_data[(y1 * m_width + x1) * m_num_channels + c];
+                ret.m_data[(static_cast<size_t>(y) * ret.m_width + x) * m_num_channels + c] =
+                    static_cast<unsigned char>(sum / 4);
+            }
+        }
+    }
+    return ret;
+}
+
 } // namespace game_engine
\ No newline at end of file
@@ -4,16 +4,35 @@
 
 namespace game_engine {
 
+class buffer_pool_t;
+
+/**
+ * @brief Conversions applied to an image right after decoding.
+ */
+struct image_options_t {
+    bool m_flip_vertically{true};
+    bool m_premultiply_alpha{false};
+    bool m_srgb_to_linear{false};
+
+    /**
+     * Pool the decoder allocates from, both for scratch memory and for the pixels. Must outlive the image. Uses the
+     * system allocator when null.
+     */
+    buffer_pool_t *m_buffer_pool{};
+};
+
 class image_t {
   public:
     /**
-     * @brief Creates the image object while loading it from the filesystem.
+     * @brief Creates the image object while loading it from the filesystem. The pixels are always stored as RGBA, so
+     * every upload is 4-byte aligned and avoids the slow RGB unpack paths of drivers.
      * @param path
+     * @param options Conversions to apply after decoding.
      */
-    explicit image_t(const std::filesystem::path &path);
+    explicit image_t(const std::filesystem::path &path, const image_options_t &options = {});
 
     /**
-     * Frees STB buffer.
+     * Returns the pixel buffer to its pool, or frees it.
      */
     ~image_t();
 
@@ -57,11 +76,26 @@ class image_t {
      */
     [[nodiscard]] bool has_alpha() const;
 
+    /**
+     * @brief Gets the number of color channels per pixel.
+     * @return Number of channels.
+     */
+    [[nodiscard]] int get_num_channels() const;
+
+    /**
+     * @brief Builds the next mip level by averaging each 2x2 block of pixels.
+     * @return Image of half the width and height, at least one pixel each, allocated from the same pool.
+     */
+    [[nodiscard]] image_t downsample() const;
+
   private:
+    image_t() = default;
+
     int m_width{};
     int m_height{};
     int m_num_channels{};
     unsigned char *m_data{};
+    buffer_pool_t *m_buffer_pool{};
 };
 
 } // namespace game_engine
@@ -0,0 +1,77 @@
+#include "instance_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <glad/glad.h>
+#include <utility>
+
+namespace game_engine {
+
+namespace {
+
+void bind_attribute(unsigned location, int components, size_t offset) {
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, components, GL_FLOAT, GL_FALSE, sizeof(instance_t),
+                          reinterpret_cast<const void *>(static_cast<uintptr_t>(offset)));
+    glVertexAttribDivisor(location, 1);
+}
+
+void bind_integer_attribute(unsigned location, int components, size_t offset) {
+    glEnableVertexAttribArray(location);
+    glVertexAttribIPointer(location, components, GL_UNSIGNED_INT, sizeof(instance_t),
+                           reinterpret_cast<const void *>(static_cast<uintptr_t>(offset)));
+    glVertexAttribDivisor(location, 1);
+}
+
+} // namespace
+
+instance_buffer_t::instance_buffer_t() {
+    glGenBuffers(1, &m_handle);
+}
+
+instance_buffer_t::~instance_buffer_t() {
+    if (0 != m_handle) {
+        glDeleteBuffers(1, &m_handle);
+    }
+}
+
+instance_buffer_t::instance_buffer_t(instance_buffer_t &&other) noexcept
+    : m_handle(other.m_handle), m_capacity(other.m_capacity) {
+    other.m_handle = 0;
+}
+
+instance_buffer_t &instance_buffer_t::operator=(instance_buffer_t &&other) noexcept {
+    std::swap(m_handle, other.m_handle);
+    std::swap(m_capacity, other.m_capacity);
+    return *this;
+}
+
+void instance_buffer_t::update(const std::vector<instance_t> &instances) {
+    const auto size = instances.size() * sizeof(instance_t);
+    glBindBuffer(GL_ARRAY_BUFFER, m_handle);
+
+    // Grows geometrically, so frames adding a few instances do not reallocate every time.
+    m_capacity = std::max(m_capacity, size > m_capacity ? size * 2 : size);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_capacity), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), instances.data());
+}
+
+void instance_buffer_t::bind_attributes(size_t first_instance) const {
+    glBindBuffer(GL_ARRAY_BUFFER, m_handle);
+
+    // Matrices take one location per column.
+    const auto base = first_instance * sizeof(instance_t);
+    for (unsigned column = 0; column < 4; ++column) {
+        bind_attribute(m_model_location + column, 4,
+                       base + offsetof(instance_t, m_model) + column * sizeof(glm::vec4));
+    }
+    for (unsigned column = 0; column < 3; ++column) {
+        bind_attribute(m_normal_matrix_location + column, 3,
+                       base + offsetof(instance_t, m_normal_matrix) + column * sizeof(glm::vec3));
+    }
+    bind_attribute(m_material_location, 4, base + offsetof(instance_t, m_material));
+    bind_attribute(m_material_texture_location, 2, base + offsetof(instance_t, m_material_texture));
+    bind_integer_attribute(m_lights_location, 2, base + offsetof(instance_t, m_light_offset));
+}
+
+} // namespace game_engine
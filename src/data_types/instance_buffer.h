@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Per-instance vertex attributes, mirroring the instance attributes declared by the vertex shaders.
+ */
+struct instance_t {
+    glm::mat4 m_model{1.0F};
+    glm::mat3 m_normal_matrix{1.0F};
+    glm::vec4 m_material{};         // Ambient color and shininess.
+    glm::vec2 m_material_texture{}; // Layer of texture2 and mix factor between texture1 and texture2.
+    uint32_t m_light_offset{};      // First index of the instance in the object light list.
+    uint32_t m_light_count{};       // Lights affecting the instance, or the largest value if not listed.
+};
+
+/**
+ * @brief Vertex buffer holding the instance attributes of a frame's draws, each one a contiguous range of it.
+ */
+class instance_buffer_t {
+  public:
+    static constexpr unsigned m_model_location = 3;
+    static constexpr unsigned m_normal_matrix_location = 7;
+    static constexpr unsigned m_material_location = 10;
+    static constexpr unsigned m_material_texture_location = 11;
+    static constexpr unsigned m_lights_location = 12;
+
+    /**
+     * @brief Allocates the buffer. Requires a current OpenGL context.
+     */
+    instance_buffer_t();
+
+    /**
+     * Deletes the buffer.
+     */
+    ~instance_buffer_t();
+
+    instance_buffer_t(instance_buffer_t &&other) noexcept;
+    instance_buffer_t &operator=(instance_buffer_t &&other) noexcept;
+    instance_buffer_t(const instance_buffer_t &) = delete;
+    instance_buffer_t &operator=(const instance_buffer_t &) = delete;
+
+    /**
+     * @brief Replaces the buffer contents. The previous storage is orphaned, so draws still reading it do not stall
+     * the upload.
+     * @param instances Instance attributes of the frame.
+     */
+    void update(const std::vector<instance_t> &instances);
+
+    /**
+     * @brief Points the instance attributes of the currently bound vertex array to a range of the buffer.
+     * @param first_instance Index of the first instance of the range.
+     */
+    void bind_attributes(size_t first_instance) const;
+
+  private:
+    unsigned m_handle{};
+    size_t m_capacity{};
+};
+
+} // namespace game_engine
@@ -58,7 +58,8 @@ mesh_t::mesh_t(game_engine::mesh_t &&other) noexcept
       m_vertices(std::move(other.m_vertices)), m_texture_coords(std::move(other.m_texture_coords)),
       m_vertex_normals(std::move(other.m_vertex_normals)), m_used_material(std::move(other.m_used_material)),
       m_smooth_shading(other.m_smooth_shading), m_faces(std::move(other.m_faces)),
-      m_cached_vertices(std::move(other.m_cached_vertices)) {
+      m_cached_vertices(std::move(other.m_cached_vertices)), m_triangle_indices(std::move(other.m_triangle_indices)),
+      m_bounds(other.m_bounds), m_triangles(std::move(other.m_triangles)) {
 
     other.m_smooth_shading = false;
 }
@@ -73,6 +74,9 @@ mesh_t &mesh_t::operator=(game_engine::mesh_t &&other) noexcept {
     std::swap(m_smooth_shading, other.m_smooth_shading);
     std::swap(m_faces, other.m_faces);
     std::swap(m_cached_vertices, other.m_cached_vertices);
+    std::swap(m_triangle_indices, other.m_triangle_indices);
+    std::swap(m_bounds, other.m_bounds);
+    std::swap(m_triangles, other.m_triangles);
     return *this;
 }
 
@@ -87,6 +91,9 @@ mesh_t &mesh_t::operator=(const game_engine::mesh_t &other) {
         m_smooth_shading = other.m_smooth_shading;
         m_faces = other.m_faces;
         m_cached_vertices = other.m_cached_vertices;
+        m_triangle_indices = other.m_triangle_indices;
+        m_bounds = other.m_bounds;
+        m_triangles = other.m_triangles;
     }
     return *this;
 }
@@ -99,24 +106,70 @@ const std::string &mesh_t::get_name() const {
     return m_name;
 }
 
+const std::vector<glm::vec3> &mesh_t::get_positions() const {
+    return m_vertices;
+}
+
+const std::vector<uint32_t> &mesh_t::get_triangle_indices() const {
+    return m_triangle_indices;
+}
+
+const aabb_t &mesh_t::get_bounds() const {
+    return m_bounds;
+}
+
+float mesh_t::intersect(const ray_t &ray, float max_distance) const {
+    if (!m_triangles) {
+        return -1.0F;
+    }
+
+    return m_triangles->query_ray(ray.m_origin, ray.m_direction, max_distance, [&](uint32_t triangle) {
+        const auto *indices = &m_triangle_indices[static_cast<size_t>(triangle) * 3];
+        return intersect_triangle(ray, m_vertices[indices[0]], m_vertices[indices[1]], m_vertices[indices[2]]);
+    });
+}
+
+void mesh_t::append_vertices(const glm::mat4 &transform, const glm::mat3 &normal_matrix,
+                             std::vector<opengl_cpp::vertex_t> &ret) const {
+    ret.reserve(ret.size() + m_faces.size() * 3);
+    for (const auto &face : m_faces) {
+        assert(3 == face.size());
+        for (const auto &corner : face) {
+            ret.push_back({glm::vec3(transform * glm::vec4(m_vertices[corner.m_vertex_index - 1], 1.0F)),
+                           {m_texture_coords[corner.m_texture_coord_index - 1]},
+                           {normal_matrix * m_vertex_normals[corner.m_normal_index - 1]}});
+        }
+    }
+}
+
 void mesh_t::cache_vertices() {
+    m_bounds = aabb_t();
+    for (const auto &vertex : m_vertices) {
+        m_bounds.merge(vertex);
+    }
+
     m_cached_vertices.clear();
-    m_cached_vertices.reserve(m_faces.size() * 3);
+    append_vertices(glm::mat4(1.0F), glm::mat3(1.0F), m_cached_vertices);
+    m_triangle_indices.clear();
+    m_triangle_indices.reserve(m_faces.size() * 3);
     for (const auto &face : m_faces) {
-        assert(3 == face.size());
-        opengl_cpp::vertex_t v1{m_vertices[face[0].m_vertex_index - 1],
-                                {m_texture_coords[face[0].m_texture_coord_index - 1]},
-                                {m_vertex_normals[face[0].m_normal_index - 1]}};
-        opengl_cpp::vertex_t v2{m_vertices[face[1].m_vertex_index - 1],
-                                {m_texture_coords[face[1].m_texture_coord_index - 1]},
-                                {m_vertex_normals[face[1].m_normal_index - 1]}};
-        opengl_cpp::vertex_t v3{m_vertices[face[2].m_vertex_index - 1],
-                                {m_texture_coords[face[2].m_texture_coord_index - 1]},
-                                {m_vertex_normals[face[2].m_normal_index - 1]}};
-        m_cached_vertices.emplace_back(v1);
-        m_cached_vertices.emplace_back(v2);
-        m_cached_vertices.emplace_back(v3);
+        for (const auto &corner : face) {
+            m_triangle_indices.emplace_back(static_cast<uint32_t>(corner.m_vertex_index - 1));
+        }
+    }
+
+    // Handles are assigned in insertion order, so each one is also the index of its triangle. The hierarchy never
+    // changes afterwards and is shared by copies of the mesh.
+    auto triangles = std::make_shared<bvh_t>();
+    for (size_t i = 0; i < m_triangle_indices.size(); i += 3) {
+        aabb_t bounds;
+        bounds.merge(m_vertices[m_triangle_indices[i]]);
+        bounds.merge(m_vertices[m_triangle_indices[i + 1]]);
+        bounds.merge(m_vertices[m_triangle_indices[i + 2]]);
+        triangles->insert(bounds);
     }
+    triangles->rebuild();
+    m_triangles = std::move(triangles);
 }
 
 } // namespace game_engine
\ No newline at end of file
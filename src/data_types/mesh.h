@@ -1,7 +1,12 @@
 #pragma once
 
 #include "data_types/face.h"
+#include "utils/aabb.h"
+#include "utils/bvh.h"
+#include "utils/ray.h"
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <opengl-cpp/vertex_array.h>
 #include <string>
 #include <vector>
@@ -20,8 +25,41 @@ class mesh_t {
     mesh_t &operator=(const mesh_t &other);
 
     [[nodiscard]] const std::vector<opengl_cpp::vertex_t> &get_vertices() const;
+
+    /**
+     * @brief Appends the vertices of get_vertices() once transformed, e.g. to world space to merge meshes.
+     * @param transform Transform applied to the positions.
+     * @param normal_matrix Transform applied to the normals, the inverse transpose of that of the positions.
+     * @param ret Receives the vertices.
+     */
+    void append_vertices(const glm::mat4 &transform, const glm::mat3 &normal_matrix,
+                         std::vector<opengl_cpp::vertex_t> &ret) const;
+
     [[nodiscard]] const std::string &get_name() const;
 
+    /**
+     * @brief Gets the distinct vertex positions, in object space.
+     */
+    [[nodiscard]] const std::vector<glm::vec3> &get_positions() const;
+
+    /**
+     * @brief Gets three indices in get_positions() per triangle.
+     */
+    [[nodiscard]] const std::vector<uint32_t> &get_triangle_indices() const;
+
+    /**
+     * @brief Gets the box bounding the vertices, in object space.
+     */
+    [[nodiscard]] const aabb_t &get_bounds() const;
+
+    /**
+     * @brief Intersects a ray with the triangles, walking a hierarchy built over them when the mesh was loaded.
+     * @param ray Ray, in object space.
+     * @param max_distance Distance past which hits are ignored.
+     * @return Distance of the closest hit along the ray, or a negative value if there is none.
+     */
+    [[nodiscard]] float intersect(const ray_t &ray, float max_distance) const;
+
   private:
     std::string m_material_library{"mtllib_undefined"};
     std::string m_name{"name_undefined"};
@@ -33,6 +71,9 @@ class mesh_t {
     std::vector<std::vector<face_t>> m_faces;
 
     std::vector<opengl_cpp::vertex_t> m_cached_vertices;
+    std::vector<uint32_t> m_triangle_indices;
+    aabb_t m_bounds;
+    std::shared_ptr<const bvh_t> m_triangles;
 
     void cache_vertices();
 };
@@ -0,0 +1,260 @@
+#include "program.h"
+
+#include "utils/exception.h"
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cassert>
+#include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <mutex>
+#include <opengl-cpp/shader.h>
+#include <unordered_map>
+#include <utility>
+
+namespace game_engine {
+
+namespace {
+
+bool is_sampler(GLenum type) {
+    switch (type) {
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_BUFFER:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+size_t get_uniform_id(std::string_view name) {
+    static std::mutex s_mutex;
+    static std::unordered_map<std::string, size_t> s_ids;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_ids.emplace(std::string(name), s_ids.size()).first->second;
+}
+
+program_t::program_t(opengl_cpp::gl_t &gl, std::filesystem::path vert_path, std::filesystem::path frag_path)
+    : m_gl(&gl), m_vert_path(std::move(vert_path)), m_frag_path(std::move(frag_path)) {
+}
+
+program_t::program_t(const program_binary_t &binary) {
+    m_handle = glCreateProgram();
+    glProgramBinary(m_handle, binary.m_format, binary.m_data.data(), static_cast<GLsizei>(binary.m_data.size()));
+
+    GLint status{};
+    glGetProgramiv(m_handle, GL_LINK_STATUS, &status);
+    if (GL_TRUE != status) {
+        glDeleteProgram(m_handle);
+        throw exception_t("program binary rejected");
+    }
+
+    reflect_uniforms();
+    m_status = program_status_t::ready;
+}
+
+program_t::~program_t() {
+    if (!m_program && 0 != m_handle) {
+        glDeleteProgram(m_handle);
+    }
+}
+
+void program_t::build() {
+    if (program_status_t::pending != m_status) {
+        return;
+    }
+
+    using opengl_cpp::shader_t;
+    using opengl_cpp::shader_type_t;
+
+    try {
+        auto program = std::make_unique<opengl_cpp::program_t>(*m_gl);
+        program->add_shader(shader_t(*m_gl, shader_type_t::vertex, m_vert_path));
+        program->add_shader(shader_t(*m_gl, shader_type_t::fragment, m_frag_path));
+        program->link();
+
+        // opengl-cpp does not expose the program object, which reflection and block bindings need.
+        program->use();
+        GLint handle{};
+        glGetIntegerv(GL_CURRENT_PROGRAM, &handle);
+        m_program = std::move(program);
+        m_handle = static_cast<unsigned>(handle);
+    } catch (const std::exception &e) {
+        m_error = e.what();
+        BOOST_LOG_TRIVIAL(error) << "Program " << m_vert_path << " and " << m_frag_path << ": " << m_error;
+        m_status = program_status_t::failed;
+        return;
+    }
+
+    reflect_uniforms();
+    apply_block_bindings();
+    m_status = program_status_t::ready;
+}
+
+void program_t::use() {
+    build();
+    if (program_status_t::failed == m_status) {
+        throw exception_t(m_error);
+    }
+    if (m_program) {
+        m_program->use();
+    } else {
+        glUseProgram(m_handle);
+    }
+}
+
+bool program_t::is_ready() const {
+    return program_status_t::ready == m_status;
+}
+
+program_status_t program_t::get_status() const {
+    return m_status;
+}
+
+void program_t::bind_uniform_block(const char *block_name, unsigned binding) {
+    m_block_bindings.emplace_back(block_name, binding);
+    if (program_status_t::ready == m_status) {
+        apply_block_bindings();
+    }
+}
+
+program_binary_t program_t::get_binary() const {
+    assert(program_status_t::ready == m_status);
+
+    program_binary_t ret;
+    if (!is_binary_supported()) {
+        return ret;
+    }
+
+    GLint length{};
+    glGetProgramiv(m_handle, GL_PROGRAM_BINARY_LENGTH, &length);
+    ret.m_data.resize(static_cast<size_t>(length));
+    if (length > 0) {
+        GLenum format{};
+        glGetProgramBinary(m_handle, length, nullptr, &format, ret.m_data.data());
+        ret.m_format = format;
+    }
+    return ret;
+}
+
+bool program_t::is_binary_supported() {
+    // Core since 4.1, otherwise provided by ARB_get_program_binary. Without either, the query reports no format.
+    GLint format_count{};
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    return format_count > 0;
+}
+
+unsigned program_t::get_handle() const {
+    return m_handle;
+}
+
+const std::vector<program_t::uniform_info_t> &program_t::get_uniforms() const {
+    return m_uniforms;
+}
+
+void program_t::apply_block_bindings() {
+    for (const auto &binding : m_block_bindings) {
+        const auto block_index = glGetUniformBlockIndex(m_handle, binding.first.c_str());
+        if (GL_INVALID_INDEX != block_index) {
+            glUniformBlockBinding(m_handle, block_index, binding.second);
+        }
+    }
+}
+
+void program_t::reflect_uniforms() {
+    GLint count{};
+    glGetProgramiv(m_handle, GL_ACTIVE_UNIFORMS, &count);
+    GLint max_length{};
+    glGetProgramiv(m_handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+    std::string name(static_cast<size_t>(std::max(max_length, 1)), '\0');
+    for (GLuint i = 0; i < static_cast<GLuint>(count); ++i) {
+        GLsizei length{};
+        GLint size{};
+        GLenum type{};
+        glGetActiveUniform(m_handle, i, max_length, &length, &size, &type, name.data());
+
+        uniform_info_t info;
+        info.m_name.assign(name.data(), static_cast<size_t>(length));
+        info.m_location = glGetUniformLocation(m_handle, info.m_name.c_str());
+        info.m_type = type;
+        info.m_size = size;
+
+        // Members of uniform blocks have no location and are fed through uniform buffers instead.
+        if (info.m_location < 0) {
+            continue;
+        }
+
+        // Arrays are reported by their first element, but addressed by their plain name.
+        const std::string_view array_suffix = "[0]";
+        if (info.m_name.size() > array_suffix.size() &&
+            0 == info.m_name.compare(info.m_name.size() - array_suffix.size(), array_suffix.size(), array_suffix)) {
+            info.m_name.resize(info.m_name.size() - array_suffix.size());
+        }
+
+        const auto id = get_uniform_id(info.m_name);
+        if (id >= m_uniform_slots.size()) {
+            m_uniform_slots.resize(id + 1, m_no_uniform);
+        }
+        m_uniform_slots[id] = m_uniforms.size();
+        m_uniforms.emplace_back(std::move(info));
+    }
+
+    BOOST_LOG_TRIVIAL(debug) << "Program " << m_handle << " has " << m_uniforms.size() << " active uniforms";
+}
+
+const program_t::statistics_t &program_t::get_statistics() const {
+    return m_statistics;
+}
+
+program_t::uniform_info_t *program_t::find_uniform(size_t id) {
+    if (id >= m_uniform_slots.size() || m_no_uniform == m_uniform_slots[id]) {
+        return nullptr;
+    }
+    return &m_uniforms[m_uniform_slots[id]];
+}
+
+void program_t::upload(const uniform_info_t &info, bool value) {
+    assert(GL_BOOL == info.m_type);
+    glUniform1i(info.m_location, static_cast<GLint>(value));
+}
+
+void program_t::upload(const uniform_info_t &info, int value) {
+    assert(GL_INT == info.m_type || GL_BOOL == info.m_type || is_sampler(info.m_type));
+    glUniform1i(info.m_location, value);
+}
+
+void program_t::upload(const uniform_info_t &info, float value) {
+    assert(GL_FLOAT == info.m_type);
+    glUniform1f(info.m_location, value);
+}
+
+void program_t::upload(const uniform_info_t &info, const glm::vec2 &value) {
+    assert(GL_FLOAT_VEC2 == info.m_type);
+    glUniform2fv(info.m_location, 1, glm::value_ptr(value));
+}
+
+void program_t::upload(const uniform_info_t &info, const glm::vec3 &value) {
+    assert(GL_FLOAT_VEC3 == info.m_type);
+    glUniform3fv(info.m_location, 1, glm::value_ptr(value));
+}
+
+void program_t::upload(const uniform_info_t &info, const glm::vec4 &value) {
+    assert(GL_FLOAT_VEC4 == info.m_type);
+    glUniform4fv(info.m_location, 1, glm::value_ptr(value));
+}
+
+void program_t::upload(const uniform_info_t &info, const glm::mat3 &value) {
+    assert(GL_FLOAT_MAT3 == info.m_type);
+    glUniformMatrix3fv(info.m_location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void program_t::upload(const uniform_info_t &info, const glm::mat4 &value) {
+    assert(GL_FLOAT_MAT4 == info.m_type);
+    glUniformMatrix4fv(info.m_location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+} // namespace game_engine
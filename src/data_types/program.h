@@ -0,0 +1,194 @@
+#pragma once
+
+#include "utils/program_cache.h"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <memory>
+#include <opengl-cpp/program.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Gets the process-wide identifier of a uniform name, assigning a new one on first use.
+ * @param name Uniform name, as reported by the driver (e.g. "uniform_material.ambient").
+ * @return Identifier, the same for every program.
+ */
+size_t get_uniform_id(std::string_view name);
+
+/**
+ * @brief Typed handle to a uniform. Names are resolved once, so the same handle can be held by call sites and used
+ * with every program, which maps it to its own location without string lookups.
+ * @tparam value_t Uploaded value type.
+ */
+template <class value_t> class uniform_t {
+  public:
+    explicit uniform_t(std::string_view name) : m_id(get_uniform_id(name)) {
+    }
+
+    [[nodiscard]] size_t get_id() const {
+        return m_id;
+    }
+
+  private:
+    size_t m_id;
+};
+
+enum class program_status_t {
+    pending,
+    ready,
+    failed
+};
+
+/**
+ * @brief Shader program built with opengl_cpp::program_t. Programs built from source stay pending until build() is
+ * called, which lets program_factory_t spread compilation over frames. Once linked, active uniforms are reflected into
+ * a compact table indexed by uniform identifier, which also shadows the last value uploaded to each of them.
+ */
+class program_t {
+  public:
+    struct uniform_info_t {
+        std::string m_name;
+        int m_location{-1};
+        unsigned m_type{};
+        int m_size{};
+        std::array<unsigned char, sizeof(glm::mat4)> m_shadow{};
+        bool m_shadowed{};
+    };
+
+    struct statistics_t {
+        size_t m_issued_updates{};
+        size_t m_skipped_updates{};
+    };
+
+    /**
+     * @brief Creates a pending program, compiled from the shader files on the first call to build().
+     * @param gl OpenGL backend.
+     * @param vert_path Vertex shader source.
+     * @param frag_path Fragment shader source.
+     */
+    program_t(opengl_cpp::gl_t &gl, std::filesystem::path vert_path, std::filesystem::path frag_path);
+
+    /**
+     * @brief Loads a program from a binary previously retrieved with get_binary(). opengl-cpp cannot load binaries, so
+     * the program object is created directly and owned by this program. Requires a current OpenGL context.
+     * @param binary Program binary.
+     * @throws exception_t if the driver rejects the binary, e.g. after a driver update.
+     */
+    explicit program_t(const program_binary_t &binary);
+
+    /**
+     * Deletes the program object if it was loaded from a binary.
+     */
+    ~program_t();
+
+    program_t(const program_t &) = delete;
+    program_t(program_t &&) = delete;
+    program_t &operator=(const program_t &) = delete;
+    program_t &operator=(program_t &&) = delete;
+
+    /**
+     * @brief Compiles and links a pending program, blocking until the driver is done. Failures are logged and leave
+     * the program failed. Does nothing if the program is no longer pending.
+     */
+    void build();
+
+    /**
+     * @brief Makes the program current, building it first if it is still pending.
+     * @throws exception_t with the driver log if compilation or linking failed.
+     */
+    void use();
+
+    /**
+     * @brief Tells whether the program was built successfully. Never blocks.
+     */
+    [[nodiscard]] bool is_ready() const;
+
+    [[nodiscard]] program_status_t get_status() const;
+
+    /**
+     * @brief Uploads a uniform value. The program must be in use. Uniforms the program does not declare, or that
+     * the linker optimized out, are ignored, as are values bitwise identical to the last one uploaded.
+     * @param uniform Uniform handle.
+     * @param value Value to upload.
+     */
+    template <class value_t> void set(const uniform_t<value_t> &uniform, const value_t &value) {
+        auto *info = find_uniform(uniform.get_id());
+        if (nullptr == info) {
+            return;
+        }
+
+        static_assert(sizeof(value_t) <= sizeof(uniform_info_t::m_shadow), "uniform value too large to shadow");
+        if (info->m_shadowed && 0 == std::memcmp(info->m_shadow.data(), &value, sizeof(value_t))) {
+            ++m_statistics.m_skipped_updates;
+            return;
+        }
+        std::memcpy(info->m_shadow.data(), &value, sizeof(value_t));
+        info->m_shadowed = true;
+
+        ++m_statistics.m_issued_updates;
+        upload(*info, value);
+    }
+
+    /**
+     * @brief Points a uniform block to a uniform buffer binding point, once the program is linked. Programs that do
+     * not declare the block are left untouched.
+     * @param block_name Uniform block name, as declared in the shaders.
+     * @param binding Uniform buffer binding point.
+     */
+    void bind_uniform_block(const char *block_name, unsigned binding);
+
+    /**
+     * @brief Retrieves the linked program as a binary that can be loaded back in later runs. The program must be
+     * ready.
+     * @return Binary, empty if the driver does not support program binaries, or does not keep them for programs
+     * linked without GL_PROGRAM_BINARY_RETRIEVABLE_HINT, which opengl-cpp links before it could be set.
+     */
+    [[nodiscard]] program_binary_t get_binary() const;
+
+    /**
+     * @brief Tells whether the driver supports at least one program binary format.
+     */
+    static bool is_binary_supported();
+
+    [[nodiscard]] unsigned get_handle() const;
+    [[nodiscard]] const std::vector<uniform_info_t> &get_uniforms() const;
+    [[nodiscard]] const statistics_t &get_statistics() const;
+
+  private:
+    static constexpr size_t m_no_uniform = static_cast<size_t>(-1);
+
+    // Null for programs loaded from a binary, whose handle is owned directly.
+    opengl_cpp::gl_t *m_gl{};
+    std::unique_ptr<opengl_cpp::program_t> m_program;
+    std::filesystem::path m_vert_path;
+    std::filesystem::path m_frag_path;
+    unsigned m_handle{};
+    program_status_t m_status{program_status_t::pending};
+    std::string m_error;
+    std::vector<std::pair<std::string, unsigned>> m_block_bindings;
+    std::vector<uniform_info_t> m_uniforms;
+    std::vector<size_t> m_uniform_slots;
+    statistics_t m_statistics;
+
+    void apply_block_bindings();
+    void reflect_uniforms();
+    [[nodiscard]] uniform_info_t *find_uniform(size_t id);
+
+    static void upload(const uniform_info_t &info, bool value);
+    static void upload(const uniform_info_t &info, int value);
+    static void upload(const uniform_info_t &info, float value);
+    static void upload(const uniform_info_t &info, const glm::vec2 &value);
+    static void upload(const uniform_info_t &info, const glm::vec3 &value);
+    static void upload(const uniform_info_t &info, const glm::vec4 &value);
+    static void upload(const uniform_info_t &info, const glm::mat3 &value);
+    static void upload(const uniform_info_t &info, const glm::mat4 &value);
+};
+
+} // namespace game_engine
@@ -1,17 +1,31 @@
 #include "shape.h"
 
+#include "data_types/texture_array.h"
 #include "parsers/obj_parser.h"
 #include <boost/log/trivial.hpp>
+#include <cassert>
 #include <glm/ext/matrix_transform.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 
 namespace game_engine {
 
-shape_t::shape_t(opengl_cpp::vertex_array_t va) : m_vertex_array(std::move(va)) {
+namespace {
+
+const mesh_pointer_t &get_empty_mesh() {
+    static const auto ret = std::make_shared<const mesh_t>();
+    return ret;
+}
+
+} // namespace
+
+shape_t::shape_t(vertex_array_pointer_t va) : m_mesh(get_empty_mesh()), m_vertex_array(std::move(va)) {
+    assert(m_vertex_array);
 }
 
 shape_t::shape_t(game_engine::shape_t &&other) noexcept
     : m_mesh(std::move(other.m_mesh)), m_transform(std::move(other.m_transform)),
-      m_material(std::move(other.m_material)), m_vertex_array(std::move(other.m_vertex_array)) {
+      m_material(std::move(other.m_material)), m_vertex_array(std::move(other.m_vertex_array)),
+      m_first_vertex(other.m_first_vertex), m_vertex_count(other.m_vertex_count), m_bounds(other.m_bounds) {
 }
 
 shape_t &shape_t::operator=(shape_t &&other) noexcept {
@@ -19,44 +33,118 @@ shape_t &shape_t::operator=(shape_t &&other) noexcept {
     m_transform = std::move(other.m_transform);
     m_material = std::move(other.m_material);
     m_vertex_array = std::move(other.m_vertex_array);
+    m_first_vertex = other.m_first_vertex;
+    m_vertex_count = other.m_vertex_count;
+    m_bounds = other.m_bounds;
+    m_transform_cached = false;
     return *this;
 }
 
-void shape_t::load_vertices() {
-    m_vertex_array.load(m_mesh.get_vertices());
-}
+namespace {
 
-void shape_t::bind() {
-    if (m_material.m_texture1) {
-        m_material.m_texture1->bind();
+template <class texture_type_t>
+void bind_texture(const std::shared_ptr<texture_type_t> &texture, int texture_unit, bound_textures_t &bound_textures) {
+    if (!texture || bound_textures.at(texture_unit) == texture.get()) {
+        return;
     }
-    if (m_material.m_texture2) {
-        m_material.m_texture2->bind();
-    }
-    if (m_material.m_diffuse) {
-        m_material.m_diffuse->bind();
-    }
-    if (m_material.m_specular) {
-        m_material.m_specular->bind();
+    texture->bind();
+    bound_textures.at(texture_unit) = texture.get();
+}
+
+void touch_texture(const texture_pointer_t &texture, texture_residency_t &residency) {
+    if (texture) {
+        residency.touch(texture.get());
     }
+}
+
+} // namespace
+
+void shape_t::bind_textures(bound_textures_t &bound_textures, texture_residency_t &residency) {
+    touch_texture(m_material.m_texture1, residency);
+    touch_texture(m_material.m_diffuse, residency);
+    touch_texture(m_material.m_specular, residency);
+
+    bind_texture(m_material.m_texture1, configuration::texture_layer_1, bound_textures);
+    bind_texture(m_material.m_texture2, configuration::texture_layer_2, bound_textures);
+    bind_texture(m_material.m_diffuse, configuration::texture_diffuse, bound_textures);
+    bind_texture(m_material.m_specular, configuration::texture_specular, bound_textures);
+}
+
+void shape_t::bind_vertex_array() {
+    m_vertex_array->bind();
+}
 
-    m_vertex_array.bind();
+const opengl_cpp::vertex_array_t &shape_t::get_vertex_array() const {
+    return *m_vertex_array;
 }
 
-glm::mat4 shape_t::model_transformations() const {
-    auto model = glm::mat4(1.0F);
-    model = glm::translate(model, m_transform.m_translation);
-    model = glm::rotate(model, glm::radians(m_transform.m_rotation_angle), m_transform.m_rotation_axis);
-    model = glm::scale(model, m_transform.m_scale);
-    return model;
+void shape_t::set_vertex_range(size_t first, size_t count, const aabb_t &bounds) {
+    m_first_vertex = first;
+    m_vertex_count = count;
+    m_bounds = bounds;
+    m_transform_cached = false;
+}
+
+size_t shape_t::get_first_vertex() const {
+    return m_first_vertex;
+}
+
+size_t shape_t::get_vertex_count() const {
+    return m_vertex_count;
+}
+
+const glm::mat4 &shape_t::model_transformations() const {
+    update_transform_cache();
+    return m_model;
+}
+
+const glm::mat3 &shape_t::normal_matrix() const {
+    update_transform_cache();
+    return m_normal_matrix;
+}
+
+const aabb_t &shape_t::world_bounds() const {
+    update_transform_cache();
+    return m_world_bounds;
+}
+
+float shape_t::intersect(const ray_t &ray, float max_distance) const {
+    // The direction is not renormalized, so distances in object space are the same as in world space.
+    return m_mesh->intersect(ray.transform(glm::inverse(model_transformations())), max_distance);
+}
+
+void shape_t::update_transform_cache() const {
+    // The transform is exposed by reference, so changes are detected by comparing against the cached copy.
+    if (m_transform_cached && m_cached_transform.m_translation == m_transform.m_translation &&
+        m_cached_transform.m_rotation_angle == m_transform.m_rotation_angle &&
+        m_cached_transform.m_rotation_axis == m_transform.m_rotation_axis &&
+        m_cached_transform.m_scale == m_transform.m_scale) {
+        return;
+    }
+
+    m_model = glm::mat4(1.0F);
+    m_model = glm::translate(m_model, m_transform.m_translation);
+    m_model = glm::rotate(m_model, glm::radians(m_transform.m_rotation_angle), m_transform.m_rotation_axis);
+    m_model = glm::scale(m_model, m_transform.m_scale);
+
+    // The translation does not affect normals, so the upper 3x3 block is enough.
+    m_normal_matrix = glm::inverseTranspose(glm::mat3(m_model));
+    m_world_bounds = m_bounds.transform(m_model);
+    m_cached_transform = m_transform;
+    m_transform_cached = true;
 }
 
-mesh_t &shape_t::get_mesh() {
-    return m_mesh;
+const mesh_t &shape_t::get_mesh() const {
+    return *m_mesh;
 }
 
-void shape_t::set_mesh(mesh_t m) {
+void shape_t::set_mesh(mesh_pointer_t m) {
+    assert(m);
     m_mesh = std::move(m);
+    m_first_vertex = 0;
+    m_vertex_count = m_mesh->get_vertices().size();
+    m_bounds = m_mesh->get_bounds();
+    m_transform_cached = false;
 }
 
 transform_t &shape_t::get_transform() {
@@ -2,7 +2,10 @@
 
 #include "data_types/face.h"
 #include "data_types/mesh.h"
+#include "data_types/texture_residency.h"
 #include "data_types/types.h"
+#include "utils/configuration.h"
+#include <array>
 #include <filesystem>
 #include <glm/glm.hpp>
 #include <map>
@@ -14,9 +17,19 @@
 
 namespace game_engine {
 
+/**
+ * @brief Object last bound to each texture unit, so consecutive shapes sharing textures skip the rebinds.
+ */
+using bound_textures_t = std::array<const void *, configuration::texture_unit_count>;
+
 class shape_t {
   public:
-    explicit shape_t(opengl_cpp::vertex_array_t va);
+    /**
+     * @brief Creates a shape drawn from a vertex array, which shapes with the same mesh share so they can be drawn
+     * with a single instanced call.
+     * @param va Vertex array, already loaded with the mesh vertices.
+     */
+    explicit shape_t(vertex_array_pointer_t va);
     shape_t(shape_t &&other) noexcept;
     shape_t &operator=(shape_t &&other) noexcept;
     ~shape_t() = default;
@@ -24,12 +37,55 @@ class shape_t {
     shape_t &operator=(const shape_t &other) = delete;
     shape_t(const shape_t &other) = delete;
 
-    void load_vertices();
-    void bind();
-    [[nodiscard]] glm::mat4 model_transformations() const;
+    void bind_textures(bound_textures_t &bound_textures, texture_residency_t &residency);
+    void bind_vertex_array();
+
+    /**
+     * @brief Gets the model matrix, recomputed only when the transform changed since the last call.
+     */
+    [[nodiscard]] const glm::mat4 &model_transformations() const;
+
+    /**
+     * @brief Gets the inverse transpose of the model matrix, which transforms normals to world space. Cached along
+     * with the model matrix.
+     */
+    [[nodiscard]] const glm::mat3 &normal_matrix() const;
+
+    /**
+     * @brief Gets the world-space box bounding the mesh. Cached along with the model matrix.
+     */
+    [[nodiscard]] const aabb_t &world_bounds() const;
+
+    /**
+     * @brief Intersects a world-space ray with the mesh triangles.
+     * @param ray Ray, in world space.
+     * @param max_distance Distance past which hits are ignored.
+     * @return Distance of the closest hit along the ray, or a negative value if there is none.
+     */
+    [[nodiscard]] float intersect(const ray_t &ray, float max_distance) const;
+
+    [[nodiscard]] const opengl_cpp::vertex_array_t &get_vertex_array() const;
 
-    mesh_t &get_mesh();
-    void set_mesh(mesh_t m);
+    /**
+     * @brief Restricts drawing to a range of the vertex array, for shapes sharing one that holds several meshes, such
+     * as groups of merged static geometry. set_mesh() resets the range to the whole mesh.
+     * @param first First vertex drawn.
+     * @param count Number of vertices drawn.
+     * @param bounds Object-space box bounding the range, replacing that of the mesh.
+     */
+    void set_vertex_range(size_t first, size_t count, const aabb_t &bounds);
+
+    [[nodiscard]] size_t get_first_vertex() const;
+    [[nodiscard]] size_t get_vertex_count() const;
+
+    [[nodiscard]] const mesh_t &get_mesh() const;
+
+    /**
+     * @brief Sets the geometry the shape is built from, shared with every other shape using the same mesh. Shapes
+     * start with an empty mesh.
+     * @param m Mesh, matching the vertex array.
+     */
+    void set_mesh(mesh_pointer_t m);
 
     transform_t &get_transform();
     void set_transform(transform_t t);
@@ -38,10 +94,21 @@ class shape_t {
     void set_material(material_t m);
 
   private:
-    mesh_t m_mesh;
+    mesh_pointer_t m_mesh;
     transform_t m_transform;
     material_t m_material;
-    opengl_cpp::vertex_array_t m_vertex_array;
+    vertex_array_pointer_t m_vertex_array;
+    size_t m_first_vertex{};
+    size_t m_vertex_count{};
+    aabb_t m_bounds;
+
+    mutable transform_t m_cached_transform;
+    mutable glm::mat4 m_model{1.0F};
+    mutable glm::mat3 m_normal_matrix{1.0F};
+    mutable aabb_t m_world_bounds;
+    mutable bool m_transform_cached{false};
+
+    void update_transform_cache() const;
 };
 
 } // namespace game_engine
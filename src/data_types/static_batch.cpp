@@ -0,0 +1,69 @@
+#include "static_batch.h"
+
+#include "utils/configuration.h"
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <opengl-cpp/vertex_array.h>
+
+namespace game_engine {
+
+static_batch_t::static_batch_t(opengl_cpp::gl_t &gl) : m_gl(gl), m_grouping(configuration::static_batch_cell_size) {
+}
+
+void static_batch_t::build(const std::vector<shape_t *> &shapes) {
+    m_members.clear();
+    m_groups.clear();
+
+    std::vector<static_groups_t::member_t> layout;
+    for (auto *shape : shapes) {
+        m_members.push_back({shape, shape->model_transformations(), shape->get_material()});
+        layout.push_back({shape->get_material(), shape->world_bounds(), shape->get_mesh().get_vertices().size()});
+    }
+    m_grouping.build(layout);
+    if (m_members.empty()) {
+        return;
+    }
+
+    std::vector<opengl_cpp::vertex_t> vertices;
+    vertices.reserve(m_grouping.get_vertex_count());
+    for (const auto &group : m_grouping.get_groups()) {
+        for (const auto index : group.m_members) {
+            const auto &member = m_members[index];
+            member.m_shape->get_mesh().append_vertices(member.m_model, member.m_shape->normal_matrix(), vertices);
+        }
+    }
+    assert(vertices.size() == m_grouping.get_vertex_count());
+
+    auto vertex_array = std::make_shared<opengl_cpp::vertex_array_t>(m_gl);
+    vertex_array->load(vertices);
+    for (const auto &group : m_grouping.get_groups()) {
+        auto &shape = *m_groups.emplace_back(std::make_shared<shape_t>(vertex_array));
+        shape.set_material(group.m_material);
+        shape.set_vertex_range(group.m_first_vertex, group.m_vertex_count, group.m_bounds);
+    }
+}
+
+bool static_batch_t::is_stale(size_t member) const {
+    const auto &value = m_members.at(member);
+    return 0 != std::memcmp(&value.m_model, &value.m_shape->model_transformations(), sizeof(value.m_model)) ||
+           !is_same_material(value.m_material, value.m_shape->get_material());
+}
+
+size_t static_batch_t::get_group(size_t member) const {
+    return m_grouping.get_group(member);
+}
+
+const std::vector<shape_pointer_t> &static_batch_t::get_groups() const {
+    return m_groups;
+}
+
+size_t static_batch_t::get_member_count() const {
+    return m_members.size();
+}
+
+size_t static_batch_t::get_vertex_count() const {
+    return m_grouping.get_vertex_count();
+}
+
+} // namespace game_engine
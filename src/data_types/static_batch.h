@@ -0,0 +1,63 @@
+#pragma once
+
+#include "data_types/shape.h"
+#include "data_types/types.h"
+#include "utils/static_groups.h"
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <opengl-cpp/backend/gl.h>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Geometry of shapes that never move, merged into a single vertex array. Vertices are pre-transformed to world
+ * space and grouped by material and grid cell, see static_groups_t, and each group is drawn by a shape covering its
+ * range of the array with an identity transform, so the whole batch takes one vertex array bind and a draw per group.
+ */
+class static_batch_t {
+  public:
+    explicit static_batch_t(opengl_cpp::gl_t &gl);
+
+    /**
+     * @brief Merges shapes, replacing the previous contents of the batch.
+     * @param shapes Shapes to merge, which must outlive the batch or the next build().
+     */
+    void build(const std::vector<shape_t *> &shapes);
+
+    /**
+     * @brief Tests whether a merged shape was moved or had its material changed since build(), so the batch no longer
+     * matches it.
+     * @param member Index of the shape in the shapes passed to build().
+     */
+    [[nodiscard]] bool is_stale(size_t member) const;
+
+    /**
+     * @brief Gets the group a shape was merged into.
+     * @param member Index of the shape in the shapes passed to build().
+     * @return Index in get_groups().
+     */
+    [[nodiscard]] size_t get_group(size_t member) const;
+
+    /**
+     * @brief Gets the shapes drawing each group.
+     */
+    [[nodiscard]] const std::vector<shape_pointer_t> &get_groups() const;
+
+    [[nodiscard]] size_t get_member_count() const;
+    [[nodiscard]] size_t get_vertex_count() const;
+
+  private:
+    struct member_t {
+        shape_t *m_shape;
+        glm::mat4 m_model;
+        material_t m_material;
+    };
+
+    opengl_cpp::gl_t &m_gl;
+    std::vector<member_t> m_members;
+    static_groups_t m_grouping;
+    std::vector<shape_pointer_t> m_groups;
+};
+
+} // namespace game_engine
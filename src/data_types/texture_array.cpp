@@ -0,0 +1,73 @@
+#include "texture_array.h"
+
+#include "utils/exception.h"
+#include <glad/glad.h>
+#include <string>
+
+namespace game_engine {
+
+texture_array_t::texture_array_t(int texture_unit, int width, int height, int layer_count)
+    : m_texture_unit(texture_unit), m_width(width), m_height(height), m_layer_count(layer_count) {
+
+    glGenTextures(1, &m_handle);
+    bind();
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, m_width, m_height, m_layer_count, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 nullptr);
+}
+
+texture_array_t::~texture_array_t() {
+    if (0 != m_handle) {
+        glDeleteTextures(1, &m_handle);
+    }
+}
+
+texture_array_t::texture_array_t(texture_array_t &&other) noexcept
+    : m_handle(other.m_handle), m_texture_unit(other.m_texture_unit), m_width(other.m_width),
+      m_height(other.m_height), m_layer_count(other.m_layer_count) {
+
+    other.m_handle = 0;
+}
+
+texture_array_t &texture_array_t::operator=(texture_array_t &&other) noexcept {
+    std::swap(m_handle, other.m_handle);
+    std::swap(m_texture_unit, other.m_texture_unit);
+    std::swap(m_width, other.m_width);
+    std::swap(m_height, other.m_height);
+    std::swap(m_layer_count, other.m_layer_count);
+    return *this;
+}
+
+void texture_array_t::bind() {
+    glActiveTexture(GL_TEXTURE0 + m_texture_unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_handle);
+}
+
+void texture_array_t::set_layer(int layer, const image_t &image) {
+    if (layer < 0 || layer >= m_layer_count) {
+        throw exception_t("texture array layer out of range: " + std::to_string(layer));
+    }
+    if (image.get_width() != m_width || image.get_height() != m_height) {
+        throw exception_t("texture array layer size mismatch: " + std::to_string(image.get_width()) + "x" +
+                          std::to_string(image.get_height()));
+    }
+
+    bind();
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_width, m_height, 1, image.has_alpha() ? GL_RGBA : GL_RGB,
+                    GL_UNSIGNED_BYTE, image.get_data());
+}
+
+void texture_array_t::generate_mipmap() {
+    bind();
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+}
+
+int texture_array_t::get_layer_count() const {
+    return m_layer_count;
+}
+
+} // namespace game_engine
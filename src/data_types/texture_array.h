@@ -0,0 +1,59 @@
+#pragma once
+
+#include "data_types/image.h"
+
+namespace game_engine {
+
+/**
+ * @brief GL_TEXTURE_2D_ARRAY holding several same-sized images, each addressed by its layer index. Shapes sampling
+ * different layers of the same array can be drawn back-to-back without rebinding textures.
+ */
+class texture_array_t {
+  public:
+    /**
+     * @brief Allocates storage for the texture array.
+     * @param texture_unit Texture unit the array is bound to.
+     * @param width Width of every layer.
+     * @param height Height of every layer.
+     * @param layer_count Number of layers.
+     */
+    texture_array_t(int texture_unit, int width, int height, int layer_count);
+
+    /**
+     * Deletes the texture object.
+     */
+    ~texture_array_t();
+
+    texture_array_t(texture_array_t &&other) noexcept;
+    texture_array_t &operator=(texture_array_t &&other) noexcept;
+    texture_array_t(const texture_array_t &) = delete;
+    texture_array_t &operator=(const texture_array_t &) = delete;
+
+    /**
+     * @brief Binds the array to its texture unit.
+     */
+    void bind();
+
+    /**
+     * @brief Uploads an image into one layer. The image must match the array dimensions.
+     * @param layer Destination layer.
+     * @param image Source image.
+     */
+    void set_layer(int layer, const image_t &image);
+
+    /**
+     * @brief Generates the mipmap chain of every layer.
+     */
+    void generate_mipmap();
+
+    [[nodiscard]] int get_layer_count() const;
+
+  private:
+    unsigned m_handle{};
+    int m_texture_unit{};
+    int m_width{};
+    int m_height{};
+    int m_layer_count{};
+};
+
+} // namespace game_engine
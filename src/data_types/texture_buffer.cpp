@@ -0,0 +1,65 @@
+#include "texture_buffer.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+#include <utility>
+
+namespace game_engine {
+
+namespace {
+
+// Empty buffers are still given storage, so shaders never fetch from a buffer texture without any.
+constexpr size_t min_capacity = 16;
+
+} // namespace
+
+texture_buffer_t::texture_buffer_t(unsigned internal_format, unsigned unit) : m_unit(unit), m_capacity(min_capacity) {
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, m_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(m_capacity), nullptr, GL_STREAM_DRAW);
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_BUFFER, m_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, internal_format, m_buffer);
+}
+
+texture_buffer_t::~texture_buffer_t() {
+    if (0 != m_texture) {
+        glDeleteTextures(1, &m_texture);
+    }
+    if (0 != m_buffer) {
+        glDeleteBuffers(1, &m_buffer);
+    }
+}
+
+texture_buffer_t::texture_buffer_t(texture_buffer_t &&other) noexcept
+    : m_buffer(other.m_buffer), m_texture(other.m_texture), m_unit(other.m_unit), m_capacity(other.m_capacity) {
+    other.m_buffer = 0;
+    other.m_texture = 0;
+}
+
+texture_buffer_t &texture_buffer_t::operator=(texture_buffer_t &&other) noexcept {
+    std::swap(m_buffer, other.m_buffer);
+    std::swap(m_texture, other.m_texture);
+    std::swap(m_unit, other.m_unit);
+    std::swap(m_capacity, other.m_capacity);
+    return *this;
+}
+
+void texture_buffer_t::update(const void *data, size_t size) {
+    glBindBuffer(GL_TEXTURE_BUFFER, m_buffer);
+
+    // Grows geometrically, so frames adding a few texels do not reallocate every time. The texture refers to the
+    // buffer object rather than its storage, so it follows reallocations.
+    m_capacity = std::max(m_capacity, size > m_capacity ? size * 2 : size);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(m_capacity), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+}
+
+void texture_buffer_t::bind() const {
+    glActiveTexture(GL_TEXTURE0 + m_unit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+} // namespace game_engine
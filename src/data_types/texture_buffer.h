@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+namespace game_engine {
+
+/**
+ * @brief Buffer object read by shaders through a buffer texture, with texelFetch() on a samplerBuffer. Unlike uniform
+ * buffers, its size is only bounded by GL_MAX_TEXTURE_BUFFER_SIZE texels.
+ */
+class texture_buffer_t {
+  public:
+    /**
+     * @brief Allocates the buffer and the texture viewing it. Requires a current OpenGL context.
+     * @param internal_format Sized format the texels are read as, e.g. GL_RGBA32F.
+     * @param unit Texture unit bind() attaches the texture to.
+     */
+    texture_buffer_t(unsigned internal_format, unsigned unit);
+
+    /**
+     * Deletes the texture and the buffer.
+     */
+    ~texture_buffer_t();
+
+    texture_buffer_t(texture_buffer_t &&other) noexcept;
+    texture_buffer_t &operator=(texture_buffer_t &&other) noexcept;
+    texture_buffer_t(const texture_buffer_t &) = delete;
+    texture_buffer_t &operator=(const texture_buffer_t &) = delete;
+
+    /**
+     * @brief Replaces the buffer contents. The previous storage is orphaned, so draws still reading it do not stall
+     * the upload.
+     * @param data Texel data.
+     * @param size Number of bytes.
+     */
+    void update(const void *data, size_t size);
+
+    /**
+     * @brief Attaches the texture to its texture unit, leaving the first unit active.
+     */
+    void bind() const;
+
+  private:
+    unsigned m_buffer{};
+    unsigned m_texture{};
+    unsigned m_unit{};
+    size_t m_capacity{};
+};
+
+} // namespace game_engine
@@ -0,0 +1,186 @@
+#include "texture_residency.h"
+
+#include "data_types/image.h"
+#include "utils/configuration.h"
+#include "utils/exception.h"
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cassert>
+#include <chrono>
+
+namespace game_engine {
+
+namespace {
+
+image_pointer_t downsample(image_t image, int level) {
+    for (int i = 0; i < level; ++i) {
+        image = image.downsample();
+    }
+    return std::make_shared<const image_t>(std::move(image));
+}
+
+} // namespace
+
+texture_residency_t::texture_residency_t(size_t budget_bytes, texture_uploader_t &uploader) : m_uploader(uploader) {
+    m_statistics.m_budget_bytes = budget_bytes;
+}
+
+void texture_residency_t::add(const texture_pointer_t &texture, std::filesystem::path path,
+                              const image_options_t &options) {
+    assert(texture);
+
+    image_t image(path, options);
+    entry_t entry;
+    entry.m_texture = texture;
+    entry.m_path = std::move(path);
+    entry.m_options = options;
+    entry.m_width = image.get_width();
+    entry.m_height = image.get_height();
+    entry.m_last_used_frame = m_frame;
+    while ((std::min(entry.m_width, entry.m_height) >> (entry.m_max_base_level + 1)) >=
+           configuration::texture_residency_min_size) {
+        ++entry.m_max_base_level;
+    }
+
+    // The smallest level fits in a frame's upload budget, so the texture is drawn blurry right away rather than missing
+    // until its full resolution is through. Only the full resolution image is kept until then.
+    if (entry.m_max_base_level > 0) {
+        m_uploader.enqueue(texture, downsample(image.downsample(), entry.m_max_base_level - 1),
+                           entry.m_max_base_level);
+    }
+    m_uploader.enqueue(texture, std::make_shared<const image_t>(std::move(image)), 0);
+
+    m_statistics.m_resident_bytes += level_bytes(entry, 0);
+    m_entries.emplace(texture.get(), std::move(entry));
+}
+
+void texture_residency_t::touch(const opengl_cpp::texture_t *texture) {
+    auto find = m_entries.find(texture);
+    if (m_entries.end() == find) {
+        return;
+    }
+
+    auto &entry = find->second;
+    if (entry.m_last_used_frame != m_frame && entry.m_base_level > 0) {
+        m_requests.emplace_back(texture);
+        ++m_statistics.m_stalls;
+    }
+    entry.m_last_used_frame = m_frame;
+}
+
+void texture_residency_t::update() {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.m_texture.expired()) {
+            m_statistics.m_resident_bytes -= level_bytes(it->second, it->second.m_base_level);
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    upload_decoded_levels();
+
+    for (const auto *texture : m_requests) {
+        auto find = m_entries.find(texture);
+        if (m_entries.end() == find || 0 == find->second.m_base_level || find->second.m_decoded_level.valid()) {
+            continue;
+        }
+
+        auto &entry = find->second;
+        const auto extra_bytes =
+            level_bytes(entry, entry.m_base_level - 1) - level_bytes(entry, entry.m_base_level);
+        if (make_room(extra_bytes)) {
+            load_level(entry, entry.m_base_level - 1);
+            ++m_statistics.m_stream_ins;
+        }
+    }
+    m_requests.clear();
+
+    make_room(0);
+    ++m_frame;
+}
+
+void texture_residency_t::set_budget(size_t budget_bytes) {
+    m_statistics.m_budget_bytes = budget_bytes;
+}
+
+const texture_residency_t::statistics_t &texture_residency_t::get_statistics() const {
+    return m_statistics;
+}
+
+bool texture_residency_t::make_room(size_t bytes) {
+    while (m_statistics.m_resident_bytes + bytes > m_statistics.m_budget_bytes) {
+        entry_t *victim = nullptr;
+        for (auto &entry : m_entries) {
+            if (entry.second.m_last_used_frame == m_frame ||
+                entry.second.m_base_level >= entry.second.m_max_base_level || entry.second.m_decoded_level.valid()) {
+                continue;
+            }
+            if (nullptr == victim || entry.second.m_last_used_frame < victim->m_last_used_frame) {
+                victim = &entry.second;
+            }
+        }
+
+        if (nullptr == victim) {
+            return false;
+        }
+
+        load_level(*victim, victim->m_base_level + 1);
+        ++m_statistics.m_evictions;
+    }
+    return true;
+}
+
+void texture_residency_t::load_level(entry_t &entry, int base_level) {
+    auto texture = entry.m_texture.lock();
+    if (!texture) {
+        return;
+    }
+
+    if (base_level > entry.m_base_level) {
+        m_uploader.drop_levels(std::move(texture), base_level);
+    } else {
+        // Decoding takes longer than a frame, so it runs on its own thread. The pool it allocates from is thread-safe.
+        entry.m_decoded_level = std::async(std::launch::async, [path = entry.m_path, options = entry.m_options,
+                                                                base_level] {
+            return downsample(image_t(path, options), base_level);
+        });
+    }
+
+    m_statistics.m_resident_bytes -= level_bytes(entry, entry.m_base_level);
+    m_statistics.m_resident_bytes += level_bytes(entry, base_level);
+    BOOST_LOG_TRIVIAL(debug) << "Texture " << entry.m_path << " now resident from mip " << base_level;
+    entry.m_base_level = base_level;
+}
+
+void texture_residency_t::upload_decoded_levels() {
+    for (auto &[key, entry] : m_entries) {
+        if (!entry.m_decoded_level.valid() ||
+            std::future_status::ready != entry.m_decoded_level.wait_for(std::chrono::seconds(0))) {
+            continue;
+        }
+
+        try {
+            auto image = entry.m_decoded_level.get();
+            if (auto texture = entry.m_texture.lock()) {
+                m_uploader.enqueue(std::move(texture), std::move(image), entry.m_base_level);
+            }
+        } catch (const exception_t &e) {
+            // The texture keeps being drawn from the levels it has, so it is accounted for as such.
+            BOOST_LOG_TRIVIAL(warning) << "Failed to stream in texture " << entry.m_path << ": " << e.what();
+            m_statistics.m_resident_bytes -= level_bytes(entry, entry.m_base_level);
+            ++entry.m_base_level;
+            m_statistics.m_resident_bytes += level_bytes(entry, entry.m_base_level);
+        }
+    }
+}
+
+size_t texture_residency_t::level_bytes(const entry_t &entry, int base_level) {
+    const auto width = static_cast<size_t>(std::max(1, entry.m_width >> base_level));
+    const auto height = static_cast<size_t>(std::max(1, entry.m_height >> base_level));
+
+    // Images are always decoded to RGBA, and the full mip chain adds a third on top of the base level.
+    return width * height * 4 * 4 / 3;
+}
+
+} // namespace game_engine
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "data_types/image.h"
+#include "data_types/texture_uploader.h"
+#include "data_types/types.h"
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <unordered_map>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Keeps the GPU memory used by textures under a byte budget. Textures that were not used recently get their
+ * highest mip levels dropped, least recently used first, and get them streamed back in once they are drawn again.
+ * Decoded images are released once uploaded, so a stream-in decodes the file again, on its own thread, and downsamples
+ * it to the level needed, which then goes through the asynchronous uploader like any other texture image.
+ */
+class texture_residency_t {
+  public:
+    struct statistics_t {
+        size_t m_resident_bytes{};
+        size_t m_budget_bytes{};
+        size_t m_evictions{};
+        size_t m_stream_ins{};
+        size_t m_stalls{};
+    };
+
+    /**
+     * @brief Creates the residency tracker.
+     * @param budget_bytes Maximum amount of texture memory to keep resident.
+     * @param uploader Uploader the levels are streamed in and out through.
+     */
+    texture_residency_t(size_t budget_bytes, texture_uploader_t &uploader);
+
+    /**
+     * @brief Starts tracking a texture and queues its uploads: the smallest level it can be degraded to first, so it
+     * can be drawn within a frame or two, then its full resolution.
+     * @param texture Texture object, with no image yet.
+     * @param path Path of the image, decoded again for each stream-in.
+     * @param options Options to decode the image with.
+     */
+    void add(const texture_pointer_t &texture, std::filesystem::path path, const image_options_t &options);
+
+    /**
+     * @brief Marks a texture as used in the current frame. Degraded textures are queued for streaming in.
+     * @param texture Texture being bound, ignored if not tracked.
+     */
+    void touch(const opengl_cpp::texture_t *texture);
+
+    /**
+     * @brief Starts decoding the requested mip levels, queues the uploads of those decoded since the last call, and
+     * evicts least recently used levels until the budget is met. Meant to be called once per frame, after all draws.
+     */
+    void update();
+
+    void set_budget(size_t budget_bytes);
+    [[nodiscard]] const statistics_t &get_statistics() const;
+
+  private:
+    struct entry_t {
+        std::weak_ptr<opengl_cpp::texture_t> m_texture;
+        std::filesystem::path m_path;
+        image_options_t m_options;
+        int m_width{};
+        int m_height{};
+        int m_base_level{};
+        int m_max_base_level{};
+        uint64_t m_last_used_frame{};
+
+        // Base level being decoded for a stream-in, uploaded once ready.
+        std::future<image_pointer_t> m_decoded_level;
+    };
+
+    texture_uploader_t &m_uploader;
+    std::unordered_map<const opengl_cpp::texture_t *, entry_t> m_entries;
+    std::vector<const opengl_cpp::texture_t *> m_requests;
+    statistics_t m_statistics;
+    uint64_t m_frame{};
+
+    bool make_room(size_t bytes);
+    void load_level(entry_t &entry, int base_level);
+    void upload_decoded_levels();
+
+    static size_t level_bytes(const entry_t &entry, int base_level);
+};
+
+} // namespace game_engine
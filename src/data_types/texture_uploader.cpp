@@ -0,0 +1,177 @@
+#include "texture_uploader.h"
+
+#include <boost/log/trivial.hpp>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <glad/glad.h>
+#include <opengl-cpp/texture.h>
+
+namespace game_engine {
+
+texture_uploader_t::texture_uploader_t(int buffer_count, size_t bytes_per_frame)
+    : m_buffers(buffer_count), m_bytes_per_frame(bytes_per_frame) {
+
+    for (auto &buffer : m_buffers) {
+        glGenBuffers(1, &buffer.m_handle);
+    }
+}
+
+texture_uploader_t::~texture_uploader_t() {
+    for (auto &buffer : m_buffers) {
+        if (nullptr != buffer.m_fence) {
+            glDeleteSync(buffer.m_fence);
+        }
+        glDeleteBuffers(1, &buffer.m_handle);
+    }
+}
+
+void texture_uploader_t::enqueue(texture_pointer_t texture, image_pointer_t image, int level) {
+    assert(texture);
+    assert(image);
+    m_jobs.emplace_back(job_t{std::move(texture), std::move(image), level});
+    m_statistics.m_pending_uploads = m_jobs.size();
+}
+
+void texture_uploader_t::drop_levels(texture_pointer_t texture, int base_level) {
+    assert(texture);
+    m_jobs.emplace_back(job_t{std::move(texture), nullptr, base_level});
+    m_statistics.m_pending_uploads = m_jobs.size();
+}
+
+void texture_uploader_t::update() {
+    using std::chrono::duration;
+    using std::chrono::high_resolution_clock;
+
+    if (m_jobs.empty()) {
+        m_statistics.m_frame_upload_time_us = 0.0;
+        return;
+    }
+
+    const auto start_time = high_resolution_clock::now();
+    auto byte_budget = m_bytes_per_frame;
+
+    while (!m_jobs.empty() && byte_budget > 0) {
+        auto &job = m_jobs.front();
+        if (!job.m_image) {
+            set_base_level(job);
+            free_levels(job);
+            m_jobs.pop_front();
+            continue;
+        }
+
+        auto &buffer = m_buffers[m_next_buffer];
+        if (!acquire_buffer(buffer)) {
+            break;
+        }
+        m_next_buffer = (m_next_buffer + 1) % m_buffers.size();
+
+        if (0 == job.m_next_row) {
+            allocate(job);
+        }
+        const auto bytes = upload_rows(job, buffer, byte_budget);
+        if (0 == bytes) {
+            break;
+        }
+        byte_budget -= std::min(bytes, byte_budget);
+        m_statistics.m_uploaded_bytes += bytes;
+
+        if (job.m_next_row >= job.m_image->get_height()) {
+            set_base_level(job);
+            job.m_texture->generate_mipmap();
+            m_jobs.pop_front();
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    const duration<double, std::micro> upload_time_us = high_resolution_clock::now() - start_time;
+    m_statistics.m_frame_upload_time_us = upload_time_us.count();
+    m_statistics.m_upload_time_us += upload_time_us.count();
+    m_statistics.m_pending_uploads = m_jobs.size();
+}
+
+const texture_uploader_t::statistics_t &texture_uploader_t::get_statistics() const {
+    return m_statistics;
+}
+
+double texture_uploader_t::get_throughput() const {
+    if (m_statistics.m_upload_time_us <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(m_statistics.m_uploaded_bytes) / m_statistics.m_upload_time_us;
+}
+
+bool texture_uploader_t::acquire_buffer(staging_buffer_t &buffer) {
+    if (nullptr == buffer.m_fence) {
+        return true;
+    }
+
+    const auto result = glClientWaitSync(buffer.m_fence, 0, 0);
+    if (GL_TIMEOUT_EXPIRED == result) {
+        ++m_statistics.m_fence_waits;
+        return false;
+    }
+
+    // A failed wait cannot tell whether the GPU still reads the buffer, so it is skipped until the next frame. Its
+    // storage is orphaned before being written again anyway, which leaves the old one to pending transfers.
+    glDeleteSync(buffer.m_fence);
+    buffer.m_fence = nullptr;
+    if (GL_WAIT_FAILED == result) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to wait on pixel unpack buffer fence, retrying next frame";
+        ++m_statistics.m_fence_waits;
+        return false;
+    }
+    return true;
+}
+
+void texture_uploader_t::allocate(const job_t &job) {
+    // opengl-cpp only specifies level 0, which may be the one being sampled.
+    const auto &image = *job.m_image;
+    const auto format = image.has_alpha() ? GL_RGBA : GL_RGB;
+    job.m_texture->bind();
+    glTexImage2D(GL_TEXTURE_2D, job.m_level, format, image.get_width(), image.get_height(), 0, format,
+                 GL_UNSIGNED_BYTE, nullptr);
+}
+
+void texture_uploader_t::set_base_level(const job_t &job) {
+    job.m_texture->bind();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, job.m_level);
+}
+
+void texture_uploader_t::free_levels(const job_t &job) {
+    // Levels below the base are never sampled, so emptying them only gives their memory back.
+    job.m_texture->bind();
+    for (int level = 0; level < job.m_level; ++level) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+}
+
+size_t texture_uploader_t::upload_rows(job_t &job, staging_buffer_t &buffer, size_t byte_budget) {
+    const auto &image = *job.m_image;
+    const auto row_bytes = static_cast<size_t>(image.get_width()) * image.get_num_channels();
+    const auto rows_left = static_cast<size_t>(image.get_height() - job.m_next_row);
+    const auto rows = std::min(rows_left, std::max<size_t>(1, byte_budget / row_bytes));
+    const auto bytes = rows * row_bytes;
+
+    // Orphaning with glBufferData hands the driver a fresh allocation, so mapping never waits on a previous transfer.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.m_handle);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+    void *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (nullptr == mapped) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to map pixel unpack buffer, retrying next frame";
+        return 0;
+    }
+    std::memcpy(mapped, image.get_data() + job.m_next_row * row_bytes, bytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    job.m_texture->bind();
+    glTexSubImage2D(GL_TEXTURE_2D, job.m_level, 0, job.m_next_row, image.get_width(), static_cast<GLsizei>(rows),
+                    image.has_alpha() ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    buffer.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    job.m_next_row += static_cast<int>(rows);
+    return bytes;
+}
+
+} // namespace game_engine
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "data_types/image.h"
+#include "data_types/types.h"
+#include <deque>
+#include <vector>
+
+struct __GLsync;
+
+namespace game_engine {
+
+/**
+ * @brief Uploads texture images asynchronously. Pixel data is staged through a ring of orphaned pixel unpack buffers,
+ * a few rows at a time and within a per-frame byte budget, so large textures are spread over several frames instead of
+ * stalling the render loop on a synchronous copy. Images go to a mip level below the base level of the texture, which
+ * is never sampled, and only become its base level once complete.
+ */
+class texture_uploader_t {
+  public:
+    struct statistics_t {
+        size_t m_pending_uploads{};
+        size_t m_uploaded_bytes{};
+        double m_upload_time_us{};
+        double m_frame_upload_time_us{};
+        size_t m_fence_waits{};
+    };
+
+    /**
+     * @brief Creates the staging buffer ring. Requires a current OpenGL context.
+     * @param buffer_count Number of pixel unpack buffers in the ring.
+     * @param bytes_per_frame Maximum amount of pixel data staged per update() call.
+     */
+    texture_uploader_t(int buffer_count, size_t bytes_per_frame);
+
+    /**
+     * Deletes the staging buffers and their fences.
+     */
+    ~texture_uploader_t();
+
+    texture_uploader_t(const texture_uploader_t &) = delete;
+    texture_uploader_t(texture_uploader_t &&) = delete;
+    texture_uploader_t &operator=(const texture_uploader_t &) = delete;
+    texture_uploader_t &operator=(texture_uploader_t &&) = delete;
+
+    /**
+     * @brief Queues an image for upload into a mip level. Once the last row has been submitted, the level becomes the
+     * base level of the texture and the smaller levels are generated from it. Until then the texture keeps being
+     * sampled from its previous levels. Uploads and level drops queued for the same texture apply in order.
+     * @param texture Destination texture.
+     * @param image Source image, kept alive until the upload finishes. Its size must be that of the level.
+     * @param level Mip level to upload to, below the current base level of the texture unless it has none yet.
+     */
+    void enqueue(texture_pointer_t texture, image_pointer_t image, int level);
+
+    /**
+     * @brief Queues raising the base level of a texture and freeing the levels below it, once the uploads queued
+     * before are done.
+     * @param texture Texture to degrade.
+     * @param base_level New base level.
+     */
+    void drop_levels(texture_pointer_t texture, int base_level);
+
+    /**
+     * @brief Submits queued rows until the frame byte budget is spent or the next staging buffer is still in use by
+     * the GPU. Meant to be called once per frame; rebinds textures.
+     */
+    void update();
+
+    [[nodiscard]] const statistics_t &get_statistics() const;
+
+    /**
+     * @brief Gets the average upload throughput since creation.
+     * @return Throughput, in megabytes per second of CPU time spent uploading.
+     */
+    [[nodiscard]] double get_throughput() const;
+
+  private:
+    // Jobs without an image drop the levels below m_level.
+    struct job_t {
+        texture_pointer_t m_texture;
+        image_pointer_t m_image;
+        int m_level{};
+        int m_next_row{};
+    };
+
+    struct staging_buffer_t {
+        unsigned m_handle{};
+        __GLsync *m_fence{};
+    };
+
+    std::vector<staging_buffer_t> m_buffers;
+    size_t m_next_buffer{};
+    size_t m_bytes_per_frame{};
+    std::deque<job_t> m_jobs;
+    statistics_t m_statistics;
+
+    bool acquire_buffer(staging_buffer_t &buffer);
+    size_t upload_rows(job_t &job, staging_buffer_t &buffer, size_t byte_budget);
+
+    static void allocate(const job_t &job);
+    static void set_base_level(const job_t &job);
+    static void free_levels(const job_t &job);
+};
+
+} // namespace game_engine
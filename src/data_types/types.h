@@ -5,18 +5,25 @@
 #include <iomanip>
 #include <memory>
 #include <opengl-cpp/texture.h>
+#include <opengl-cpp/vertex_array.h>
 
 namespace game_engine {
 
-struct light_t;
+class image_t;
+class mesh_t;
+class program_t;
 class shape_t;
+class texture_array_t;
 
+using image_pointer_t = std::shared_ptr<const image_t>;
+using mesh_pointer_t = std::shared_ptr<const mesh_t>;
 using texture_pointer_t = std::shared_ptr<opengl_cpp::texture_t>;
-using program_pointer_t = std::shared_ptr<opengl_cpp::program_t>;
+using program_pointer_t = std::shared_ptr<program_t>;
 using texture_pointer_t = std::shared_ptr<opengl_cpp::texture_t>;
-using light_pointer_t = std::shared_ptr<light_t>;
+using texture_array_pointer_t = std::shared_ptr<texture_array_t>;
 using shape_pointer_t = std::shared_ptr<game_engine::shape_t>;
 using shape_vector_t = std::vector<shape_pointer_t>;
+using vertex_array_pointer_t = std::shared_ptr<opengl_cpp::vertex_array_t>;
 
 enum class light_type_t {
     deactivated = 0,
@@ -25,38 +32,23 @@ enum class light_type_t {
     spot = 3
 };
 
+/**
+ * @brief Parameters of a light. Directional lights ignore the position and the attenuation, and only spot lights use
+ * the cutoff angles, in degrees.
+ */
 struct light_t {
-    static constexpr auto m_type = light_type_t::ambient;
-
+    light_type_t m_type{light_type_t::ambient};
     glm::vec3 m_position{};
+    glm::vec3 m_direction{};
     glm::vec3 m_ambient{};
     glm::vec3 m_diffuse{};
     glm::vec3 m_specular{};
     float m_attenuation_constant{};
     float m_attenuation_linear{};
     float m_attenuation_quadratic{};
-    shape_pointer_t m_shape;
-
-    light_t() = default;
-    virtual ~light_t() = default;
-    light_t(const light_t &) = default;
-    light_t(light_t &&) = default;
-    light_t &operator=(const light_t &) = default;
-    light_t &operator=(light_t &&) = default;
-};
-
-struct directional_light_t : light_t {
-    static constexpr auto m_type = light_type_t::directional;
-
-    glm::vec3 m_direction;
-};
-
-struct spot_light_t : light_t {
-    static constexpr auto m_type = light_type_t::spot;
-
-    glm::vec3 m_direction;
     float m_cutoff_begin{};
     float m_cutoff_end{};
+    shape_pointer_t m_shape;
 };
 
 struct material_t {
@@ -65,7 +57,8 @@ struct material_t {
     texture_pointer_t m_specular{};
     float m_shininess{};
     texture_pointer_t m_texture1{};
-    texture_pointer_t m_texture2{};
+    texture_array_pointer_t m_texture2{};
+    int m_texture2_layer{};
     float m_texture_mix{};
 };
 
@@ -0,0 +1,40 @@
+#include "uniform_buffer.h"
+
+#include <cassert>
+#include <glad/glad.h>
+#include <utility>
+
+namespace game_engine {
+
+uniform_buffer_t::uniform_buffer_t(size_t size, unsigned binding) : m_binding(binding), m_size(size) {
+    glGenBuffers(1, &m_handle);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_handle);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(m_size), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_handle);
+}
+
+uniform_buffer_t::~uniform_buffer_t() {
+    if (0 != m_handle) {
+        glDeleteBuffers(1, &m_handle);
+    }
+}
+
+uniform_buffer_t::uniform_buffer_t(uniform_buffer_t &&other) noexcept
+    : m_handle(other.m_handle), m_binding(other.m_binding), m_size(other.m_size) {
+    other.m_handle = 0;
+}
+
+uniform_buffer_t &uniform_buffer_t::operator=(uniform_buffer_t &&other) noexcept {
+    std::swap(m_handle, other.m_handle);
+    std::swap(m_binding, other.m_binding);
+    std::swap(m_size, other.m_size);
+    return *this;
+}
+
+void uniform_buffer_t::update(size_t offset, size_t size, const void *data) {
+    assert(offset + size <= m_size);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_handle);
+    glBufferSubData(GL_UNIFORM_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+}
+
+} // namespace game_engine
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+namespace game_engine {
+
+/**
+ * @brief Uniform buffer object attached to a fixed binding point. Programs declaring a uniform block of the matching
+ * std140 layout read from it once connected through program_t::bind_uniform_block().
+ */
+class uniform_buffer_t {
+  public:
+    /**
+     * @brief Allocates the buffer and attaches it to its binding point. Requires a current OpenGL context.
+     * @param size Buffer size, in bytes.
+     * @param binding Uniform buffer binding point.
+     */
+    uniform_buffer_t(size_t size, unsigned binding);
+
+    /**
+     * Deletes the buffer.
+     */
+    ~uniform_buffer_t();
+
+    uniform_buffer_t(uniform_buffer_t &&other) noexcept;
+    uniform_buffer_t &operator=(uniform_buffer_t &&other) noexcept;
+    uniform_buffer_t(const uniform_buffer_t &) = delete;
+    uniform_buffer_t &operator=(const uniform_buffer_t &) = delete;
+
+    /**
+     * @brief Overwrites part of the buffer.
+     * @param offset Offset of the first byte to write.
+     * @param size Number of bytes to write.
+     * @param data Source data.
+     */
+    void update(size_t offset, size_t size, const void *data);
+
+  private:
+    unsigned m_handle{};
+    unsigned m_binding{};
+    size_t m_size{};
+};
+
+} // namespace game_engine
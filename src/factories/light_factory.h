@@ -8,7 +8,12 @@ namespace game_engine {
 class light_factory_t {
   public:
     light_factory_t(opengl_cpp::gl_t &gl);
-    light_pointer_t build_light(light_type_t type);
+
+    /**
+     * @brief Creates a light with the default parameters of its type.
+     * @param type Light type.
+     */
+    [[nodiscard]] light_t build_light(light_type_t type) const;
 
   private:
     opengl_cpp::gl_t &m_gl;
@@ -1,32 +1,302 @@
 #include "factories/program_factory.h"
 
+#include "generated/shader_layout.h"
+#include "utils/configuration.h"
+#include "utils/exception.h"
+#include <algorithm>
+#include <boost/log/trivial.hpp>
 #include <filesystem>
-#include <opengl-cpp/shader.h>
+#include <fstream>
+#include <glad/glad.h>
+#include <iomanip>
+#include <sstream>
 
 namespace game_engine {
 
 using std::filesystem::path;
 
-program_factory_t::program_factory_t(opengl_cpp::gl_t &gl) : m_gl(gl) {
+namespace {
+
+// Four bits for the directional light count, after the boolean features.
+static_assert(configuration::directional_light_max < 16, "light counts must fit the program feature key");
+
+std::string read_source(const path &source_path, const std::string &defines) {
+    std::ifstream file(source_path);
+    if (!file) {
+        throw exception_t("failed to open shader: " + source_path.string());
+    }
+
+    // Defines must come after the #version directive, which has to be the first line.
+    std::string version;
+    std::getline(file, version);
+
+    std::stringstream ret;
+    ret << version << "\n" << defines << file.rdbuf();
+    return ret.str();
+}
+
+/**
+ * @brief Gets a file holding the source of a variant. opengl-cpp compiles shaders from files, so variant sources are
+ * written once under configuration::program_source_directory, named after their contents.
+ */
+path get_source_file(const path &source_path, const std::string &source, const std::string &defines) {
+    if (defines.empty()) {
+        return source_path;
+    }
+
+    std::stringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << program_cache_t::make_key({source}, {})
+         << source_path.extension().string();
+    const auto ret = path(configuration::program_source_directory) / name.str();
+    if (std::filesystem::exists(ret)) {
+        return ret;
+    }
+
+    // Written aside and renamed, so a crash never leaves a partial source under the final name.
+    std::filesystem::create_directories(ret.parent_path());
+    auto temporary_path = ret;
+    temporary_path += ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::trunc);
+        file << source;
+        file.close();
+        if (!file) {
+            throw exception_t("failed to write shader variant: " + temporary_path.string());
+        }
+    }
+    std::filesystem::rename(temporary_path, ret);
+    return ret;
+}
+
+std::string get_gl_string(GLenum name) {
+    const auto *ret = glGetString(name);
+    return nullptr == ret ? std::string() : std::string(reinterpret_cast<const char *>(ret));
+}
+
+} // namespace
+
+uint32_t program_features_t::get_key() const {
+    return static_cast<uint32_t>(m_diffuse_map) | static_cast<uint32_t>(m_specular_map) << 1U |
+           static_cast<uint32_t>(m_depth_debug) << 2U | static_cast<uint32_t>(m_depth_enabled) << 3U |
+           static_cast<uint32_t>(m_directional_lights) << 4U;
+}
+
+std::string program_features_t::get_defines() const {
+    std::stringstream ret;
+    if (m_diffuse_map) {
+        ret << "#define DIFFUSE_MAP\n";
+    }
+    if (m_specular_map) {
+        ret << "#define SPECULAR_MAP\n";
+    }
+    if (m_depth_debug) {
+        ret << "#define DEPTH_DEBUG\n";
+    }
+    if (m_depth_enabled) {
+        ret << "#define DEPTH_ENABLED\n";
+    }
+    ret << "#define DIRECTIONAL_LIGHT_COUNT " << static_cast<int>(m_directional_lights) << "\n";
+    return ret.str();
+}
+
+program_factory_t::program_factory_t(opengl_cpp::gl_t &gl)
+    : m_gl(gl), m_cache(configuration::program_cache_directory),
+      m_driver(get_gl_string(GL_VENDOR) + "/" + get_gl_string(GL_RENDERER) + "/" + get_gl_string(GL_VERSION)),
+      m_binary_supported(program_t::is_binary_supported()) {
+
+    if (configuration::shader_hot_reload) {
+        try {
+            m_shader_watcher = std::make_unique<file_watcher_t>(configuration::shader_directory);
+        } catch (const exception_t &e) {
+            BOOST_LOG_TRIVIAL(warning) << "Shader hot reload disabled: " << e.what();
+        }
+    }
 }
 
-program_pointer_t program_factory_t::build_object_program() {
-    return build_program("shaders/object.vert", "shaders/object.frag");
+program_pointer_t program_factory_t::build_object_program(const program_features_t &features) {
+    auto &ret = m_object_programs[features.get_key()];
+    if (!ret) {
+        BOOST_LOG_TRIVIAL(debug) << "Building object program variant " << std::hex << features.get_key();
+        const path shader_directory(configuration::shader_directory);
+        ret = build_program(shader_directory / "object.vert", shader_directory / "object.frag", features.get_defines());
+    }
+    return ret;
 }
 
 program_pointer_t program_factory_t::build_light_program() {
-    return build_program("shaders/light.vert", "shaders/light.frag");
+    if (!m_light_program) {
+        const path shader_directory(configuration::shader_directory);
+        m_light_program = build_program(shader_directory / "light.vert", shader_directory / "light.frag");
+    }
+    return m_light_program;
+}
+
+const program_cache_t::statistics_t &program_factory_t::get_cache_statistics() const {
+    return m_cache.get_statistics();
 }
 
-program_pointer_t program_factory_t::build_program(const char *vert_source_path, const char *frag_source_path) {
-    using opengl_cpp::shader_t;
-    using opengl_cpp::shader_type_t;
+std::vector<program_factory_t::replacement_t> program_factory_t::update() {
+    if (m_shader_watcher) {
+        for (const auto &name : m_shader_watcher->poll()) {
+            for (const auto &source : m_sources) {
+                if (source.m_vert_path.filename() == name || source.m_frag_path.filename() == name) {
+                    reload(source);
+                }
+            }
+        }
+    }
 
-    auto ret = std::make_shared<opengl_cpp::program_t>(m_gl);
-    ret->add_shader(shader_t(m_gl, shader_type_t::vertex, path(vert_source_path)));
-    ret->add_shader(shader_t(m_gl, shader_type_t::fragment, path(frag_source_path)));
-    ret->link();
+    std::vector<replacement_t> ret;
+    build_pending();
+    finish_reloads(ret);
     return ret;
 }
 
-} // namespace game_engine
\ No newline at end of file
+size_t program_factory_t::get_pending_count() const {
+    size_t ret = 0;
+    for (const auto &program : get_programs()) {
+        ret += program_status_t::pending == program->get_status() ? 1 : 0;
+    }
+    for (const auto &reload : m_reloads) {
+        ret += program_status_t::pending == reload.m_current->get_status() ? 1 : 0;
+    }
+    return ret;
+}
+
+std::vector<program_pointer_t> program_factory_t::get_programs() const {
+    std::vector<program_pointer_t> ret;
+    for (const auto &program : m_object_programs) {
+        ret.emplace_back(program.second);
+    }
+    if (m_light_program) {
+        ret.emplace_back(m_light_program);
+    }
+    return ret;
+}
+
+program_pointer_t program_factory_t::build_program(const path &vert_source_path, const path &frag_source_path,
+                                                   const std::string &defines) {
+    const auto vert_source = read_source(vert_source_path, defines);
+    const auto frag_source = read_source(frag_source_path, defines);
+
+    program_pointer_t ret;
+    const auto key = program_cache_t::make_key({vert_source, frag_source}, m_driver);
+    if (m_binary_supported) {
+        auto binary = m_cache.load(key);
+        if (binary) {
+            try {
+                ret = std::make_shared<program_t>(*binary);
+            } catch (const exception_t &) {
+                BOOST_LOG_TRIVIAL(info) << "Cached program for " << frag_source_path << " rejected, recompiling";
+                m_cache.reject(key);
+            }
+        }
+    }
+
+    if (!ret) {
+        ret = std::make_shared<program_t>(m_gl, get_source_file(vert_source_path, vert_source, defines),
+                                          get_source_file(frag_source_path, frag_source, defines));
+        m_pending_builds.push_back({ret, key});
+    }
+
+    bind_uniform_blocks(*ret);
+    m_sources.push_back({vert_source_path, frag_source_path, defines, ret});
+    return ret;
+}
+
+void program_factory_t::reload(const source_t &source) {
+    auto previous = source.m_program.lock();
+    if (!previous) {
+        return;
+    }
+
+    program_pointer_t current;
+    uint64_t key{};
+    try {
+        const auto vert_source = read_source(source.m_vert_path, source.m_defines);
+        const auto frag_source = read_source(source.m_frag_path, source.m_defines);
+        current = std::make_shared<program_t>(m_gl, get_source_file(source.m_vert_path, vert_source, source.m_defines),
+                                              get_source_file(source.m_frag_path, frag_source, source.m_defines));
+        key = program_cache_t::make_key({vert_source, frag_source}, m_driver);
+    } catch (const std::exception &e) {
+        BOOST_LOG_TRIVIAL(warning) << "Not reloading " << source.m_frag_path << ": " << e.what();
+        return;
+    }
+
+    // The cache is not looked up: the sources just changed, so it can only miss.
+    bind_uniform_blocks(*current);
+
+    // A newer edit supersedes a reload still waiting to be built.
+    auto find = std::find_if(m_reloads.begin(), m_reloads.end(),
+                             [&previous](const reload_t &reload) { return reload.m_previous == previous; });
+    if (m_reloads.end() == find) {
+        m_reloads.push_back({std::move(previous), current});
+    } else {
+        const auto superseded = std::move(find->m_current);
+        m_pending_builds.erase(std::remove_if(m_pending_builds.begin(), m_pending_builds.end(),
+                                              [&superseded](const pending_build_t &pending) {
+                                                  return pending.m_program == superseded;
+                                              }),
+                               m_pending_builds.end());
+        find->m_current = current;
+    }
+    m_pending_builds.push_back({std::move(current), key});
+    BOOST_LOG_TRIVIAL(info) << "Reloading " << source.m_vert_path << " and " << source.m_frag_path;
+}
+
+void program_factory_t::build_pending() {
+    size_t built = 0;
+    while (!m_pending_builds.empty() && built < configuration::program_builds_per_frame) {
+        const auto pending = std::move(m_pending_builds.front());
+        m_pending_builds.pop_front();
+
+        // Programs used before their turn were built then.
+        if (program_status_t::pending == pending.m_program->get_status()) {
+            pending.m_program->build();
+            ++built;
+        }
+        if (m_binary_supported && pending.m_program->is_ready()) {
+            m_cache.store(pending.m_key, pending.m_program->get_binary());
+        }
+    }
+}
+
+void program_factory_t::finish_reloads(std::vector<replacement_t> &replacements) {
+    auto it = m_reloads.begin();
+    while (it != m_reloads.end()) {
+        if (it->m_current->is_ready()) {
+            for (auto &program : m_object_programs) {
+                if (program.second == it->m_previous) {
+                    program.second = it->m_current;
+                }
+            }
+            if (m_light_program == it->m_previous) {
+                m_light_program = it->m_current;
+            }
+            for (auto &source : m_sources) {
+                if (source.m_program.lock() == it->m_previous) {
+                    source.m_program = it->m_current;
+                }
+            }
+            replacements.push_back({it->m_previous, it->m_current});
+        } else if (program_status_t::failed == it->m_current->get_status()) {
+            // The error itself was logged when the build failed.
+            BOOST_LOG_TRIVIAL(warning) << "Shader reload failed, keeping the previous program";
+        } else {
+            ++it;
+            continue;
+        }
+        it = m_reloads.erase(it);
+    }
+
+    m_sources.erase(std::remove_if(m_sources.begin(), m_sources.end(),
+                                   [](const source_t &source) { return source.m_program.expired(); }),
+                    m_sources.end());
+}
+
+void program_factory_t::bind_uniform_blocks(program_t &program) {
+    program.bind_uniform_block(shaders::frame_block_t::m_block_name, configuration::uniform_block_frame);
+    program.bind_uniform_block(shaders::light_block_t::m_block_name, configuration::uniform_block_lights);
+}
+
+} // namespace game_engine
@@ -1,21 +1,137 @@
 #pragma once
 
+#include "data_types/program.h"
 #include "data_types/types.h"
+#include "utils/file_watcher.h"
+#include "utils/program_cache.h"
+#include <cstdint>
+#include <deque>
+#include <filesystem>
 #include <memory>
-#include <opengl-cpp/program.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace game_engine {
 
+/**
+ * @brief Compile-time features of an object program variant. Each one becomes a #define in the shader sources, so
+ * the variant runs straight-line code instead of branching per fragment.
+ */
+struct program_features_t {
+    bool m_diffuse_map{};
+    bool m_specular_map{};
+    bool m_depth_debug{};
+    bool m_depth_enabled{};
+    uint8_t m_directional_lights{};
+
+    /**
+     * @brief Packs the features in a bitmask identifying the variant.
+     */
+    [[nodiscard]] uint32_t get_key() const;
+
+    /**
+     * @brief Builds the #define lines enabling the features.
+     */
+    [[nodiscard]] std::string get_defines() const;
+};
+
 class program_factory_t {
   public:
-    program_factory_t(opengl_cpp::gl_t &gl);
-    program_pointer_t build_object_program();
+    struct replacement_t {
+        program_pointer_t m_previous;
+        program_pointer_t m_current;
+    };
+
+    /**
+     * @brief Creates the factory. Requires a current OpenGL context.
+     * @param gl OpenGL backend the programs are built with.
+     */
+    explicit program_factory_t(opengl_cpp::gl_t &gl);
+
+    /**
+     * @brief Gets the object program variant with the given features. New variants are loaded from the binary cache,
+     * or left pending until update() builds them.
+     * @param features Variant features.
+     * @return Cached program.
+     */
+    program_pointer_t build_object_program(const program_features_t &features);
     program_pointer_t build_light_program();
 
+    /**
+     * @brief Builds up to configuration::program_builds_per_frame pending programs, oldest first, and stores their
+     * binaries. opengl-cpp compiles and links synchronously, so this bounds the stall a frame takes from building
+     * programs, whether or not the driver could compile in parallel. Also queues the programs whose shader sources
+     * changed on disk for rebuilding. Rebuilt programs replace the previous ones once built; the previous ones are kept
+     * if rebuilding fails. Meant to be called once per frame, at the frame boundary.
+     * @return Programs replaced in this call. Holders of the previous programs should switch to the current ones.
+     */
+    std::vector<replacement_t> update();
+
+    /**
+     * @brief Gets the number of programs still compiling or linking, reloads included.
+     */
+    [[nodiscard]] size_t get_pending_count() const;
+
+    /**
+     * @brief Gets every program built so far.
+     */
+    [[nodiscard]] std::vector<program_pointer_t> get_programs() const;
+
+    [[nodiscard]] const program_cache_t::statistics_t &get_cache_statistics() const;
+
   private:
+    struct source_t {
+        std::filesystem::path m_vert_path;
+        std::filesystem::path m_frag_path;
+        std::string m_defines;
+        std::weak_ptr<program_t> m_program;
+    };
+
+    struct reload_t {
+        program_pointer_t m_previous;
+        program_pointer_t m_current;
+    };
+
+    struct pending_build_t {
+        program_pointer_t m_program;
+        uint64_t m_key{};
+    };
+
     opengl_cpp::gl_t &m_gl;
+    std::unordered_map<uint32_t, program_pointer_t> m_object_programs;
+    program_pointer_t m_light_program;
+    program_cache_t m_cache;
+    std::deque<pending_build_t> m_pending_builds;
+    std::vector<source_t> m_sources;
+    std::vector<reload_t> m_reloads;
+    std::unique_ptr<file_watcher_t> m_shader_watcher;
+    std::string m_driver;
+    bool m_binary_supported{};
+
+    /**
+     * @brief Loads a program from the binary cache, or queues it for building from source.
+     */
+    program_pointer_t build_program(const std::filesystem::path &vert_source_path,
+                                    const std::filesystem::path &frag_source_path, const std::string &defines = {});
+
+    /**
+     * @brief Queues rebuilding a program from its current sources, keeping the previous one until built.
+     */
+    void reload(const source_t &source);
+
+    /**
+     * @brief Builds the oldest pending programs and stores the binaries of those that linked.
+     */
+    void build_pending();
+
+    /**
+     * @brief Swaps in the rebuilt programs, dropping the ones that failed.
+     */
+    void finish_reloads(std::vector<replacement_t> &replacements);
 
-    program_pointer_t build_program(const char *vert_source_path, const char *frag_source_path);
+    void bind_uniform_blocks(program_t &program);
 };
 
 } // namespace game_engine
@@ -8,8 +8,7 @@ shape_factory_t::shape_factory_t(opengl_cpp::gl_t &gl, texture_factory_t &textur
 }
 
 shape_pointer_t shape_factory_t::build_cube() {
-    shape_pointer_t ret = std::make_shared<shape_t>(opengl_cpp::vertex_array_t(m_gl));
-    ret->set_mesh(mesh_t("./objects/cube.obj"));
+    auto ret = build_shape("./objects/cube.obj");
     ret->set_transform(configuration::object_cube_transforms);
 
     material_t mat;
@@ -17,7 +16,8 @@ shape_pointer_t shape_factory_t::build_cube() {
     mat.m_shininess = configuration::material_default_shininess;
     mat.m_texture_mix = configuration::material_default_texture_mix;
     mat.m_texture1 = m_texture_factory.get_base_texture();
-    mat.m_texture2 = m_texture_factory.build_blue_texture();
+    mat.m_texture2 = m_texture_factory.get_color_texture_array();
+    mat.m_texture2_layer = static_cast<int>(texture_color_t::blue);
     mat.m_diffuse = m_texture_factory.build_diffuse_texture();
     mat.m_specular = m_texture_factory.build_specular_texture();
     ret->set_material(std::move(mat));
@@ -26,8 +26,7 @@ shape_pointer_t shape_factory_t::build_cube() {
 }
 
 shape_pointer_t shape_factory_t::build_plane() {
-    shape_pointer_t ret = std::make_shared<shape_t>(opengl_cpp::vertex_array_t(m_gl));
-    ret->set_mesh(mesh_t("./objects/plane.obj"));
+    auto ret = build_shape("./objects/plane.obj");
     ret->set_transform(configuration::object_plane_transforms);
 
     material_t mat;
@@ -35,7 +34,8 @@ shape_pointer_t shape_factory_t::build_plane() {
     mat.m_shininess = configuration::material_default_shininess;
     mat.m_texture_mix = configuration::material_default_texture_mix;
     mat.m_texture1 = m_texture_factory.get_base_texture();
-    mat.m_texture2 = m_texture_factory.build_orange_texture();
+    mat.m_texture2 = m_texture_factory.get_color_texture_array();
+    mat.m_texture2_layer = static_cast<int>(texture_color_t::orange);
     mat.m_specular = m_texture_factory.build_specular_texture();
     ret->set_material(std::move(mat));
 
@@ -43,8 +43,7 @@ shape_pointer_t shape_factory_t::build_plane() {
 }
 
 shape_pointer_t shape_factory_t::build_sphere() {
-    shape_pointer_t ret = std::make_shared<shape_t>(opengl_cpp::vertex_array_t(m_gl));
-    ret->set_mesh(mesh_t("./objects/sphere.obj"));
+    auto ret = build_shape("./objects/sphere.obj");
     ret->set_transform(configuration::object_sphere_transforms);
 
     material_t mat;
@@ -52,7 +51,8 @@ shape_pointer_t shape_factory_t::build_sphere() {
     mat.m_shininess = configuration::material_sphere_shininess;
     mat.m_texture_mix = configuration::material_default_texture_mix;
     mat.m_texture1 = m_texture_factory.get_base_texture();
-    mat.m_texture2 = m_texture_factory.build_red_texture();
+    mat.m_texture2 = m_texture_factory.get_color_texture_array();
+    mat.m_texture2_layer = static_cast<int>(texture_color_t::red);
     mat.m_diffuse = m_texture_factory.build_diffuse_texture();
     mat.m_specular = m_texture_factory.build_specular_texture();
     ret->set_material(std::move(mat));
@@ -61,8 +61,7 @@ shape_pointer_t shape_factory_t::build_sphere() {
 }
 
 shape_pointer_t shape_factory_t::build_torus() {
-    shape_pointer_t ret = std::make_shared<shape_t>(opengl_cpp::vertex_array_t(m_gl));
-    ret->set_mesh(mesh_t("./objects/torus.obj"));
+    auto ret = build_shape("./objects/torus.obj");
     ret->set_transform(configuration::object_torus_transforms);
 
     material_t mat;
@@ -70,15 +69,15 @@ shape_pointer_t shape_factory_t::build_torus() {
     mat.m_shininess = configuration::material_torus_shininess;
     mat.m_texture_mix = configuration::material_default_texture_mix;
     mat.m_texture1 = m_texture_factory.get_base_texture();
-    mat.m_texture2 = m_texture_factory.build_green_texture();
+    mat.m_texture2 = m_texture_factory.get_color_texture_array();
+    mat.m_texture2_layer = static_cast<int>(texture_color_t::green);
     ret->set_material(std::move(mat));
 
     return ret;
 }
 
 shape_pointer_t shape_factory_t::build_light_shape() {
-    shape_pointer_t ret = std::make_shared<shape_t>(opengl_cpp::vertex_array_t(m_gl));
-    ret->set_mesh(mesh_t("./objects/sphere.obj"));
+    auto ret = build_shape("./objects/sphere.obj");
     ret->set_transform(configuration::object_light_transforms);
 
     material_t mat;
@@ -88,4 +87,19 @@ shape_pointer_t shape_factory_t::build_light_shape() {
     return ret;
 }
 
+shape_pointer_t shape_factory_t::build_shape(const std::string &wavefront_object_path) {
+    auto find = m_geometries.find(wavefront_object_path);
+    if (m_geometries.end() == find) {
+        geometry_t geometry;
+        geometry.m_mesh = std::make_shared<const mesh_t>(wavefront_object_path);
+        geometry.m_vertex_array = std::make_shared<opengl_cpp::vertex_array_t>(m_gl);
+        geometry.m_vertex_array->load(geometry.m_mesh->get_vertices());
+        find = m_geometries.emplace(wavefront_object_path, std::move(geometry)).first;
+    }
+
+    auto ret = std::make_shared<shape_t>(find->second.m_vertex_array);
+    ret->set_mesh(find->second.m_mesh);
+    return ret;
+}
+
 } // namespace game_engine
@@ -4,6 +4,8 @@
 #include "factories/texture_factory.h"
 #include <memory>
 #include <opengl-cpp/texture.h>
+#include <string>
+#include <unordered_map>
 
 namespace game_engine {
 
@@ -17,8 +19,20 @@ class shape_factory_t {
     shape_pointer_t build_light_shape();
 
   private:
+    struct geometry_t {
+        mesh_pointer_t m_mesh;
+        vertex_array_pointer_t m_vertex_array;
+    };
+
     opengl_cpp::gl_t &m_gl;
     texture_factory_t &m_texture_factory;
+    std::unordered_map<std::string, geometry_t> m_geometries;
+
+    /**
+     * @brief Builds a shape from a Wavefront object. Each object is parsed and uploaded once, and both its mesh and
+     * its vertex array are shared by every shape built from it.
+     */
+    shape_pointer_t build_shape(const std::string &wavefront_object_path);
 };
 
 } // namespace game_engine
@@ -1,11 +1,14 @@
 #include "factories/texture_factory.h"
 
 #include "data_types/image.h"
+#include "data_types/texture_array.h"
 #include "utils/configuration.h"
 
 namespace game_engine {
 
-texture_factory_t::texture_factory_t(opengl_cpp::gl_t &gl) : m_gl(gl) {
+texture_factory_t::texture_factory_t(opengl_cpp::gl_t &gl, texture_residency_t &residency,
+                                     buffer_pool_t &image_pool)
+    : m_gl(gl), m_residency(residency), m_image_pool(image_pool) {
 }
 
 texture_pointer_t texture_factory_t::get_base_texture() {
@@ -19,22 +22,6 @@ texture_pointer_t texture_factory_t::build_white_texture() {
     return build_texture("./textures/white.png", configuration::texture_layer_1);
 }
 
-texture_pointer_t texture_factory_t::build_blue_texture() {
-    return build_texture("./textures/blue.png", configuration::texture_layer_2);
-}
-
-texture_pointer_t texture_factory_t::build_orange_texture() {
-    return build_texture("./textures/orange.png", configuration::texture_layer_2);
-}
-
-texture_pointer_t texture_factory_t::build_red_texture() {
-    return build_texture("./textures/red.png", configuration::texture_layer_2);
-}
-
-texture_pointer_t texture_factory_t::build_green_texture() {
-    return build_texture("./textures/green.png", configuration::texture_layer_2);
-}
-
 texture_pointer_t texture_factory_t::build_diffuse_texture() {
     return build_texture("./textures/diffuse.png", configuration::texture_diffuse);
 }
@@ -43,8 +30,36 @@ texture_pointer_t texture_factory_t::build_specular_texture() {
     return build_texture("./textures/specular.png", configuration::texture_specular);
 }
 
+texture_array_pointer_t texture_factory_t::get_color_texture_array() {
+    if (m_color_texture_array) {
+        return m_color_texture_array;
+    }
+
+    const std::array<const char *, static_cast<size_t>(texture_color_t::count)> paths = {
+        "./textures/white.png", "./textures/blue.png", "./textures/orange.png", "./textures/red.png",
+        "./textures/green.png"};
+
+    image_options_t options;
+    options.m_buffer_pool = &m_image_pool;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        image_t image(paths[i], options);
+        if (!m_color_texture_array) {
+            m_color_texture_array = std::make_shared<texture_array_t>(
+                configuration::texture_layer_2, image.get_width(), image.get_height(), static_cast<int>(paths.size()));
+        }
+        m_color_texture_array->set_layer(static_cast<int>(i), image);
+    }
+    m_color_texture_array->generate_mipmap();
+    return m_color_texture_array;
+}
+
 texture_pointer_t texture_factory_t::build_texture(const char *path, int texture_layer) {
-    using opengl_cpp::texture_format_t;
+    const auto key = std::make_pair(std::string(path), texture_layer);
+    auto find = m_textures.find(key);
+    if (m_textures.end() != find) {
+        return find->second;
+    }
+
     using opengl_cpp::texture_parameter_t;
     using opengl_cpp::texture_parameter_values_t;
     using opengl_cpp::texture_target_t;
@@ -57,10 +72,10 @@ texture_pointer_t texture_factory_t::build_texture(const char *path, int texture
     ret->set_parameter(texture_parameter_t::min_filter, texture_parameter_values_t::linear_mipmap_linear);
     ret->set_parameter(texture_parameter_t::mag_filter, texture_parameter_values_t::linear);
 
-    image_t image(path);
-    ret->set_image(image.get_width(), image.get_height(),
-                   image.has_alpha() ? texture_format_t::rgba : texture_format_t::rgb, image.get_data());
-    ret->generate_mipmap();
+    image_options_t options;
+    options.m_buffer_pool = &m_image_pool;
+    m_residency.add(ret, path, options);
+    m_textures.emplace(key, ret);
     return ret;
 }
 
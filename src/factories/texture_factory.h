@@ -1,27 +1,49 @@
 #pragma once
 
+#include "data_types/texture_residency.h"
 #include "data_types/types.h"
+#include <map>
 #include <memory>
 #include <opengl-cpp/texture.h>
+#include <string>
 
 namespace game_engine {
 
+/**
+ * @brief Layers of the color texture array, in packing order.
+ */
+enum class texture_color_t {
+    white = 0,
+    blue,
+    orange,
+    red,
+    green,
+    count
+};
+
 class texture_factory_t {
   public:
-    texture_factory_t(opengl_cpp::gl_t &gl);
+    texture_factory_t(opengl_cpp::gl_t &gl, texture_residency_t &residency, buffer_pool_t &image_pool);
 
     texture_pointer_t get_base_texture();
     texture_pointer_t build_white_texture();
-    texture_pointer_t build_blue_texture();
-    texture_pointer_t build_orange_texture();
-    texture_pointer_t build_red_texture();
-    texture_pointer_t build_green_texture();
     texture_pointer_t build_diffuse_texture();
     texture_pointer_t build_specular_texture();
 
+    /**
+     * @brief Gets the array packing every solid color texture, one per texture_color_t layer. Materials that only
+     * differ by color share it and select their layer through a uniform, so no rebinding happens between them.
+     * @return Color texture array, bound to configuration::texture_layer_2.
+     */
+    texture_array_pointer_t get_color_texture_array();
+
   private:
     opengl_cpp::gl_t &m_gl;
+    texture_residency_t &m_residency;
+    buffer_pool_t &m_image_pool;
     texture_pointer_t m_base_texture;
+    texture_array_pointer_t m_color_texture_array;
+    std::map<std::pair<std::string, int>, texture_pointer_t> m_textures;
 
     texture_pointer_t build_texture(const char *path, int texture_layer);
 };
@@ -7,17 +7,20 @@
 #include <csignal>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <imgui.h>
-#include <opengl-cpp/program.h>
 
 using std::filesystem::path;
 
 namespace game_engine {
 
 integration_t::integration_t()
-    : m_texture_factory(m_gl), m_shape_factory(m_gl, m_texture_factory),
+    : m_image_pool(configuration::image_pool_max_cached_bytes),
+      m_texture_residency(configuration::texture_residency_budget, m_texture_uploader),
+      m_texture_factory(m_gl, m_texture_residency, m_image_pool),
+      m_shape_factory(m_gl, m_texture_factory),
       m_window(m_glfw, m_gl, configuration::viewport_resolution_x, configuration::viewport_resolution_y,
                "Test application"),
-      m_renderer(m_gl),
+      m_texture_uploader(configuration::texture_upload_buffer_count, configuration::texture_upload_bytes_per_frame),
+      m_renderer(m_gl, m_texture_residency),
       m_camera(configuration::camera_start_position, configuration::camera_start_front, configuration::camera_start_up),
       m_light_manager(m_gl), m_shape_manager(m_gl) {
 
@@ -110,45 +113,63 @@ void integration_t::init_callbacks() { // NOLINT(readability-function-cognitive-
 }
 
 void integration_t::build_shapes() {
-    m_shape_manager.add_object_shape(m_shape_factory.build_cube());
-    m_shape_manager.add_object_shape(m_shape_factory.build_plane());
-    m_shape_manager.add_object_shape(m_shape_factory.build_sphere());
-    m_shape_manager.add_object_shape(m_shape_factory.build_torus());
+    // Nothing moves the scenery, so it is merged; shapes edited from the UI fall back to being drawn on their own.
+    m_shape_manager.add_static_shape(m_shape_factory.build_cube());
+    m_shape_manager.add_static_shape(m_shape_factory.build_plane());
+    m_shape_manager.add_static_shape(m_shape_factory.build_sphere());
+    m_shape_manager.add_static_shape(m_shape_factory.build_torus());
 
     auto light_texture = m_texture_factory.build_white_texture();
 
-    auto *light0 = m_light_manager.add_light<spot_light_t>();
-    assert(nullptr != light0);
-    light0->m_position = configuration::light_positions[0];
-    light0->m_direction = configuration::light_directions[0];
-    light0->m_shape = m_shape_factory.build_light_shape();
-    m_shape_manager.add_light_shape(light0->m_shape);
-
-    auto *light1 = m_light_manager.add_light<directional_light_t>();
-    assert(nullptr != light1);
-    light1->m_position = configuration::light_positions[1];
-    light1->m_direction = configuration::light_directions[1];
-    light1->m_shape = m_shape_factory.build_light_shape();
-    m_shape_manager.add_light_shape(light1->m_shape);
-
-    auto *light2 = m_light_manager.add_light<directional_light_t>();
-    assert(nullptr != light2);
-    light2->m_position = configuration::light_positions[2];
-    light2->m_direction = configuration::light_directions[2];
-    light2->m_diffuse = glm::vec3(configuration::light_directional_diffuse);
-    light2->m_shape = m_shape_factory.build_light_shape();
-    m_shape_manager.add_light_shape(light2->m_shape);
+    auto light0 = m_light_manager.build_light(light_type_t::spot);
+    light0.m_position = configuration::light_positions[0];
+    light0.m_direction = configuration::light_directions[0];
+    light0.m_shape = m_shape_factory.build_light_shape();
+    m_shape_manager.add_light_shape(light0.m_shape);
+    m_light_manager.add_light(light0);
+
+    auto light1 = m_light_manager.build_light(light_type_t::directional);
+    light1.m_position = configuration::light_positions[1];
+    light1.m_direction = configuration::light_directions[1];
+    light1.m_shape = m_shape_factory.build_light_shape();
+    m_shape_manager.add_light_shape(light1.m_shape);
+    m_light_manager.add_light(light1);
+
+    auto light2 = m_light_manager.build_light(light_type_t::directional);
+    light2.m_position = configuration::light_positions[2];
+    light2.m_direction = configuration::light_directions[2];
+    light2.m_diffuse = glm::vec3(configuration::light_directional_diffuse);
+    light2.m_shape = m_shape_factory.build_light_shape();
+    m_shape_manager.add_light_shape(light2.m_shape);
+    m_light_manager.add_light(light2);
+}
+
+void integration_t::add_point_lights(size_t count) {
+    // Golden angle spiral over the plane, with colors cycling through the hues, so any count spreads evenly.
+    const auto golden_angle = 2.39996323F;
+    const auto first = m_light_manager.get_light_count(light_type_t::ambient);
+    for (size_t i = first; i < first + count; ++i) {
+        const auto angle = golden_angle * static_cast<float>(i);
+        const auto distance = configuration::light_scatter_radius * std::sqrt((static_cast<float>(i) + 0.5F) /
+                                                                              configuration::light_max);
+        auto light = m_light_manager.build_light(light_type_t::ambient);
+        light.m_position = glm::vec3(distance * std::cos(angle), configuration::light_scatter_height,
+                                     distance * std::sin(angle));
+        light.m_diffuse = glm::abs(glm::vec3(std::cos(angle), std::cos(angle + 2.0F), std::cos(angle + 4.0F)));
+        light.m_ambient = glm::vec3(0.0F);
+        light.m_attenuation_linear = configuration::light_scatter_attenuation_linear;
+        light.m_attenuation_quadratic = configuration::light_scatter_attenuation_quadratic;
+        if (light_store_t::m_invalid_handle == m_light_manager.add_light(light)) {
+            BOOST_LOG_TRIVIAL(warning) << "Light limit reached";
+            return;
+        }
+    }
 }
 
 void integration_t::render_loop() {
     m_renderer.set_depth_test(m_depth_test);
     m_renderer.set_clear_color(configuration::viewport_clear_color);
 
-    for (auto &program_shape : m_shape_manager) {
-        assert(program_shape.second);
-        program_shape.second->load_vertices();
-    }
-
     while (!m_window.get_should_close()) {
         render();
     }
@@ -162,20 +183,34 @@ void integration_t::render() {
 
     build_ui();
 
+    m_texture_uploader.update();
     m_renderer.clear();
-
-    for (auto &program_shape : m_shape_manager) {
-        assert(program_shape.first);
-        program_shape.first->use();
-
-        update_projection_uniforms(*program_shape.first);
-        m_light_manager.update_light_uniforms(*program_shape.first);
-        update_parameter_uniforms(*program_shape.first);
-
-        assert(program_shape.second);
-        update_shape_uniforms(*program_shape.first, *program_shape.second);
-        m_renderer.draw(*program_shape.second);
+    update_frame_block();
+    m_light_manager.update_light_block(m_renderer.get_frame_block());
+    m_shape_manager.update_static_batch();
+    m_shape_manager.select_programs(get_frame_features());
+
+    m_shape_manager.update_bounds();
+    m_shape_manager.update_lights(m_light_manager.get_light_spheres());
+    const auto &frame_block = m_renderer.get_frame_block();
+    m_shape_manager.query_frustum(frustum_t(frame_block.m_uniform_view_projection), m_visible_shapes);
+    m_frustum_visible_count = m_visible_shapes.size();
+    if (m_occlusion_culling) {
+        m_shape_manager.cull_occluded(frame_block.m_uniform_view_projection, frame_block.m_uniform_view_pos,
+                                      m_visible_shapes);
     }
+    m_shape_manager.build_draw_list(m_visible_shapes, m_draw_shapes);
+    for (auto *program_shape : m_draw_shapes) {
+        assert(program_shape->first);
+        assert(program_shape->second);
+        if (program_shape->first->is_ready()) {
+            m_renderer.submit(*program_shape->first, *program_shape->second,
+                              m_shape_manager.get_lights(*program_shape));
+        }
+    }
+    m_renderer.flush();
+
+    m_texture_residency.update();
 
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
@@ -199,6 +234,10 @@ void integration_t::build_ui() {
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
 
+    if (m_cursor_enabled && ImGui::IsMouseClicked(ImGuiMouseButton_Left) && !ImGui::GetIO().WantCaptureMouse) {
+        pick_shape();
+    }
+
     ImGui::Begin("OpenGL Wrapper test app");
 
     if (ImGui::CollapsingHeader("Depth parameters")) {
@@ -208,46 +247,135 @@ void integration_t::build_ui() {
         ImGui::SliderFloat("Far", &m_depth_far, m_depth_near, configuration::camera_clipping_far_max);
     }
 
-    int i = 0;
-    for (auto &light : m_light_manager) {
-        if (!light) {
-            continue;
+    if (ImGui::CollapsingHeader("Texture residency")) {
+        const auto &statistics = m_texture_residency.get_statistics();
+        ImGui::Text("Resident: %zu / %zu KiB", statistics.m_resident_bytes / 1024, statistics.m_budget_bytes / 1024);
+        ImGui::Text("Evictions: %zu", statistics.m_evictions);
+        ImGui::Text("Stream-ins: %zu", statistics.m_stream_ins);
+        ImGui::Text("Stalls: %zu", statistics.m_stalls);
+    }
+
+    if (ImGui::CollapsingHeader("Texture uploads")) {
+        const auto &statistics = m_texture_uploader.get_statistics();
+        ImGui::Text("Pending: %zu", statistics.m_pending_uploads);
+        ImGui::Text("Uploaded: %zu KiB", statistics.m_uploaded_bytes / 1024);
+        ImGui::Text("Throughput: %.1f MB/s", m_texture_uploader.get_throughput());
+        ImGui::Text("Frame upload time: %.1f us", statistics.m_frame_upload_time_us);
+        ImGui::Text("Fence waits: %zu", statistics.m_fence_waits);
+
+        const auto pool_statistics = m_image_pool.get_statistics();
+        ImGui::Text("Decode allocations: %zu (%zu reused)", pool_statistics.m_allocations, pool_statistics.m_reuses);
+        ImGui::Text("Decode system allocations: %zu", pool_statistics.m_system_allocations);
+        ImGui::Text("Decode pool cached: %zu KiB", pool_statistics.m_cached_bytes / 1024);
+    }
+
+    if (ImGui::CollapsingHeader("Programs")) {
+        const auto programs = m_shape_manager.get_programs();
+        program_t::statistics_t statistics;
+        for (const auto &program : programs) {
+            statistics.m_issued_updates += program->get_statistics().m_issued_updates;
+            statistics.m_skipped_updates += program->get_statistics().m_skipped_updates;
         }
+        ImGui::Text("Variants: %zu", programs.size());
+        ImGui::Text("Compiling: %zu", m_shape_manager.get_program_factory().get_pending_count());
+        ImGui::Text("Uniform updates issued: %zu", statistics.m_issued_updates);
+        ImGui::Text("Uniform updates skipped: %zu", statistics.m_skipped_updates);
+
+        const auto &cache_statistics = m_shape_manager.get_program_factory().get_cache_statistics();
+        ImGui::Text("Binary cache hits: %zu", cache_statistics.m_hits);
+        ImGui::Text("Binary cache misses: %zu", cache_statistics.m_misses);
+        ImGui::Text("Binary cache rejections: %zu", cache_statistics.m_rejections);
+    }
 
-        const std::string name = "Light " + std::to_string(i++);
-        if (ImGui::CollapsingHeader(name.c_str())) {
+    if (ImGui::CollapsingHeader("Bounding volume hierarchy")) {
+        const auto &statistics = m_shape_manager.get_bvh().get_statistics();
+        ImGui::Text("Objects: %zu", statistics.m_objects);
+        ImGui::Text("Nodes: %zu", statistics.m_nodes);
+        ImGui::Text("Depth: %zu", statistics.m_depth);
+        ImGui::Text("SAH cost: %.2f (built %.2f)", statistics.m_cost, statistics.m_built_cost);
+        ImGui::Text("Rebuilds: %zu", statistics.m_rebuilds);
+        ImGui::Text("Refits: %zu", statistics.m_refits);
+    }
+
+    if (ImGui::CollapsingHeader("Occlusion culling")) {
+        const auto &statistics = m_shape_manager.get_occlusion_buffer().get_statistics();
+        ImGui::Checkbox("Enabled##occlusion", &m_occlusion_culling);
+        ImGui::Text("Occluder triangles: %zu", statistics.m_occluder_triangles);
+        ImGui::Text("Tested: %zu", statistics.m_tested);
+        ImGui::Text("Occluded: %zu", statistics.m_occluded);
+    }
+
+    if (ImGui::CollapsingHeader("Light clustering")) {
+        const auto &statistics = m_light_manager.get_statistics();
+        ImGui::Text("Directional lights: %zu", m_light_manager.get_light_count(light_type_t::directional));
+        ImGui::Text("Clustered lights: %zu", statistics.m_clustered_lights);
+        ImGui::Text("Cluster light indices: %zu", statistics.m_cluster_light_indices);
+        ImGui::Text("Most lights in a cluster: %zu", statistics.m_max_cluster_lights);
+        ImGui::Text("Object light indices: %zu", m_renderer.get_statistics().m_object_lights);
+        ImGui::Text("Object light overflows: %zu", m_renderer.get_statistics().m_object_light_overflows);
+        ImGui::Text("Object light updates: %zu",
+                    m_shape_manager.get_object_lights().get_statistics().m_updated_objects);
+        if (ImGui::Button("Add point lights")) {
+            add_point_lights(configuration::light_scatter_count);
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Static geometry")) {
+        const auto &batch = m_shape_manager.get_static_batch();
+        ImGui::Text("Merged shapes: %zu", batch.get_member_count());
+        ImGui::Text("Groups: %zu", batch.get_groups().size());
+        ImGui::Text("Group cell size: %.1f", configuration::static_batch_cell_size);
+        ImGui::Text("Vertices: %zu", batch.get_vertex_count());
+    }
+
+    if (ImGui::CollapsingHeader("Render queue")) {
+        const auto &statistics = m_renderer.get_statistics();
+        ImGui::Text("Visible: %zu", m_visible_shapes.size());
+        ImGui::Text("Frustum culled: %zu", m_shape_manager.size() - m_frustum_visible_count);
+        ImGui::Text("Occlusion culled: %zu", m_frustum_visible_count - m_visible_shapes.size());
+        ImGui::Text("Draws: %zu", statistics.m_draws);
+        ImGui::Text("Instances: %zu", statistics.m_instances);
+        ImGui::Text("State changes: %zu", statistics.m_state_changes);
+        ImGui::Text("State changes avoided: %zu", statistics.m_avoided_state_changes);
+    }
 
-            ImGui::InputScalarN("Position", ImGuiDataType_Float, &light->m_position, 3);
-
-            auto *directional_light = dynamic_cast<directional_light_t *>(light.get());
-            if (nullptr != directional_light) {
-                ImGui::InputScalarN("Direction", ImGuiDataType_Float, &directional_light->m_direction, 3);
-            } else {
-                auto *spot_light = dynamic_cast<spot_light_t *>(light.get());
-                if (nullptr != spot_light) {
-                    ImGui::InputScalarN("Direction", ImGuiDataType_Float, &spot_light->m_direction, 3);
-                    ImGui::SliderFloat("Cutoff begin", &spot_light->m_cutoff_begin,
-                                       configuration::light_cutoff_begin_min, spot_light->m_cutoff_end);
-                    ImGui::SliderFloat("Cutoff end", &spot_light->m_cutoff_end, spot_light->m_cutoff_begin,
-                                       configuration::light_cutoff_end_max);
-                }
+    for (const auto handle : m_light_manager.get_handles()) {
+        const std::string name = "Light " + std::to_string(handle);
+        if (ImGui::CollapsingHeader(name.c_str())) {
+            auto light = m_light_manager.get_light(handle);
+
+            ImGui::InputScalarN("Position", ImGuiDataType_Float, &light.m_position, 3);
+
+            if (light_type_t::directional == light.m_type) {
+                ImGui::InputScalarN("Direction", ImGuiDataType_Float, &light.m_direction, 3);
+            } else if (light_type_t::spot == light.m_type) {
+                ImGui::InputScalarN("Direction", ImGuiDataType_Float, &light.m_direction, 3);
+                ImGui::SliderFloat("Cutoff begin", &light.m_cutoff_begin, configuration::light_cutoff_begin_min,
+                                   light.m_cutoff_end);
+                ImGui::SliderFloat("Cutoff end", &light.m_cutoff_end, light.m_cutoff_begin,
+                                   configuration::light_cutoff_end_max);
             }
 
             const float min_material = 0.0F;
             const float max_material = 2.0F;
-            ImGui::SliderScalarN("Ambient", ImGuiDataType_Float, &light->m_ambient, 3, &min_material, &max_material);
-            ImGui::SliderScalarN("Diffuse", ImGuiDataType_Float, &light->m_diffuse, 3, &min_material, &max_material);
-            ImGui::SliderScalarN("Specular", ImGuiDataType_Float, &light->m_specular, 3, &min_material, &max_material);
-            ImGui::InputFloat("Constant attenuation", &light->m_attenuation_constant);
-            ImGui::InputFloat("Linear attenuation", &light->m_attenuation_linear);
-            ImGui::InputFloat("Linear quadratic", &light->m_attenuation_quadratic);
+            ImGui::SliderScalarN("Ambient", ImGuiDataType_Float, &light.m_ambient, 3, &min_material, &max_material);
+            ImGui::SliderScalarN("Diffuse", ImGuiDataType_Float, &light.m_diffuse, 3, &min_material, &max_material);
+            ImGui::SliderScalarN("Specular", ImGuiDataType_Float, &light.m_specular, 3, &min_material, &max_material);
+            ImGui::InputFloat("Constant attenuation", &light.m_attenuation_constant);
+            ImGui::InputFloat("Linear attenuation", &light.m_attenuation_linear);
+            ImGui::InputFloat("Linear quadratic", &light.m_attenuation_quadratic);
+
+            m_light_manager.set_light(handle, light);
         }
     }
 
-    for (auto &program_shape : m_shape_manager) {
-        assert(program_shape.second);
-        if (ImGui::CollapsingHeader(program_shape.second->get_mesh().get_name().c_str())) {
-            shape_debug_ui(*program_shape.second);
+    if (ImGui::CollapsingHeader("Selected shape", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Text("Pick time: %.1f us", m_pick_time_us);
+        if (m_selected_shape) {
+            ImGui::Text("%s", m_selected_shape->get_mesh().get_name().c_str());
+            shape_debug_ui(*m_selected_shape);
+        } else {
+            ImGui::Text("Click a shape to select it");
         }
     }
 
@@ -256,34 +384,45 @@ void integration_t::build_ui() {
     ImGui::Render();
 }
 
-void integration_t::update_projection_uniforms(opengl_cpp::program_t &p) {
-    auto view = m_camera.look_at(m_camera.get_position() + m_camera.get_front());
-    p.set_uniform("uniform_view", view);
+void integration_t::pick_shape() {
+    using std::chrono::duration;
+    using std::chrono::high_resolution_clock;
 
-    auto projection =
-        glm::perspective(glm::radians(configuration::camera_default_fov), configuration::viewport_resolution_ratio,
-                         configuration::camera_clipping_near, configuration::camera_clipping_far);
-    p.set_uniform("uniform_projection", projection);
+    // The cursor is tracked in screen coordinates, which match the display size rather than the framebuffer's.
+    const auto &display_size = ImGui::GetIO().DisplaySize;
+    if (display_size.x <= 0.0F || display_size.y <= 0.0F) {
+        return;
+    }
+    const glm::vec2 ndc(2.0F * static_cast<float>(m_last_cursor_position_x) / display_size.x - 1.0F,
+                        1.0F - 2.0F * static_cast<float>(m_last_cursor_position_y) / display_size.y);
+
+    const auto start_time = high_resolution_clock::now();
+    const auto ray = m_camera.get_ray(m_renderer.get_frame_block().m_uniform_projection, ndc);
+    auto *picked = m_shape_manager.pick(ray, 1.0F);
+    m_pick_time_us = duration<double, std::micro>(high_resolution_clock::now() - start_time).count();
+
+    m_selected_shape = nullptr == picked ? nullptr : picked->second;
 }
 
-void integration_t::update_parameter_uniforms(opengl_cpp::program_t &p) const {
-    p.set_uniform("uniform_depth.debug", m_depth_view_debug);
-    p.set_uniform("uniform_depth.enabled", m_depth_view_enabled);
-    p.set_uniform("uniform_depth.near", m_depth_near);
-    p.set_uniform("uniform_depth.far", m_depth_far);
+void integration_t::update_frame_block() {
+    shaders::frame_block_t frame_block{};
+    frame_block.m_uniform_view = m_camera.look_at(m_camera.get_position() + m_camera.get_front());
+    frame_block.m_uniform_projection =
+        glm::perspective(glm::radians(configuration::camera_default_fov), configuration::viewport_resolution_ratio,
+                         configuration::camera_clipping_near, configuration::camera_clipping_far);
+    frame_block.m_uniform_view_projection = frame_block.m_uniform_projection * frame_block.m_uniform_view;
+    frame_block.m_uniform_view_pos = m_camera.get_position();
+    frame_block.m_uniform_depth.m_near = m_depth_near;
+    frame_block.m_uniform_depth.m_far = m_depth_far;
+    m_renderer.update_frame_block(frame_block);
 }
 
-void integration_t::update_shape_uniforms(opengl_cpp::program_t &p, shape_t &s) {
-    p.set_uniform("uniform_model", s.model_transformations());
-    p.set_uniform("uniform_material.has_diffuse", static_cast<bool>(s.get_material().m_diffuse));
-    p.set_uniform("uniform_material.has_specular", static_cast<bool>(s.get_material().m_specular));
-    p.set_uniform("uniform_material.ambient", s.get_material().m_ambient);
-    p.set_uniform("uniform_material.shininess", s.get_material().m_shininess);
-    p.set_uniform("uniform_material.texture1", configuration::texture_layer_1);
-    p.set_uniform("uniform_material.texture2", configuration::texture_layer_2);
-    p.set_uniform("uniform_material.diffuse", configuration::texture_diffuse);
-    p.set_uniform("uniform_material.specular", configuration::texture_specular);
-    p.set_uniform("uniform_material.texture_mix", s.get_material().m_texture_mix);
+program_features_t integration_t::get_frame_features() const {
+    program_features_t ret;
+    ret.m_depth_debug = m_depth_view_debug;
+    ret.m_depth_enabled = m_depth_view_enabled;
+    ret.m_directional_lights = static_cast<uint8_t>(m_light_manager.get_light_count(light_type_t::directional));
+    return ret;
 }
 
 void integration_t::shape_debug_ui(shape_t &s) {
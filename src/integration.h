@@ -1,6 +1,9 @@
 #pragma once
 #include "data_types/camera.h"
+#include "data_types/program.h"
 #include "data_types/shape.h"
+#include "data_types/texture_residency.h"
+#include "data_types/texture_uploader.h"
 #include "data_types/types.h"
 #include "data_types/window.h"
 #include "factories/light_factory.h"
@@ -10,12 +13,12 @@
 #include "managers/light_manager.h"
 #include "managers/shape_manager.h"
 #include "renderer.h"
+#include "utils/buffer_pool.h"
 #include "utils/configuration.h"
+#include "utils/frustum.h"
 #include <memory>
 #include <opengl-cpp/backend/gl_impl.h>
 #include <opengl-cpp/backend/glfw_impl.h>
-#include <opengl-cpp/program.h>
-#include <opengl-cpp/shader.h>
 #include <opengl-cpp/texture.h>
 #include <vector>
 
@@ -32,27 +35,42 @@ class integration_t {
 
     void init_callbacks();
     void build_shapes();
+
+    /**
+     * @brief Scatters point lights without shapes over the scene, to exercise the light clusters.
+     * @param count Number of lights to add, as far as configuration::light_max allows.
+     */
+    void add_point_lights(size_t count);
     void render_loop();
 
   private:
     opengl_cpp::gl_impl_t m_gl;
     opengl_cpp::glfw_impl_t m_glfw;
 
+    buffer_pool_t m_image_pool;
+    texture_residency_t m_texture_residency;
     texture_factory_t m_texture_factory;
     shape_factory_t m_shape_factory;
 
     window_t m_window;
+    texture_uploader_t m_texture_uploader;
     renderer_t m_renderer;
     camera_t m_camera;
 
     light_manager_t m_light_manager;
     shape_manager_t m_shape_manager;
+    std::vector<shape_manager_t::pair_t *> m_visible_shapes;
+    std::vector<shape_manager_t::pair_t *> m_draw_shapes;
+    size_t m_frustum_visible_count{};
+    shape_pointer_t m_selected_shape;
+    double m_pick_time_us{};
 
     bool m_wireframe{};
     bool m_cursor_enabled{true};
     bool m_depth_test{true};
     bool m_depth_view_enabled{true};
     bool m_depth_view_debug{false};
+    bool m_occlusion_culling{configuration::occlusion_culling};
     float m_depth_near{configuration::camera_clipping_near};
     float m_depth_far{configuration::camera_clipping_far};
     bool m_first_cursor_iteration = true;
@@ -62,12 +80,12 @@ class integration_t {
     double m_yaw = -90.0; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
 
     void build_ui();
-    void update_projection_uniforms(opengl_cpp::program_t &p);
-    void update_parameter_uniforms(opengl_cpp::program_t &p) const;
+    void pick_shape();
+    void update_frame_block();
+    [[nodiscard]] program_features_t get_frame_features() const;
     void render();
 
     void shape_debug_ui(shape_t &s);
-    void update_shape_uniforms(opengl_cpp::program_t &p, shape_t &s);
 };
 
 } // namespace game_engine
@@ -1,62 +1,188 @@
 #include "light_manager.h"
 
 #include "data_types/shape.h"
-#include <opengl-cpp/program.h>
+#include "utils/light_bounds.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <glad/glad.h>
 
 namespace game_engine {
 
-light_manager_t::light_manager_t(opengl_cpp::gl_t &gl) : m_gl(gl), m_light_factory(m_gl) {
+// Clusters are read as two unsigned integers per texel.
+static_assert(sizeof(cluster_grid_t::cluster_t) == 2 * sizeof(uint32_t), "clusters must match GL_RG32UI texels");
+
+namespace {
+
+// Clustered lights are read back from GL_RGBA32F texels, where the bits of a small integer make a denormal that the
+// GPU may flush to zero. Their type member holds the bits of the type as a float value instead.
+int32_t texel_type(light_type_t type) {
+    const auto value = static_cast<float>(type);
+    int32_t ret{};
+    std::memcpy(&ret, &value, sizeof(ret));
+    return ret;
 }
 
-void light_manager_t::update_light_uniforms(opengl_cpp::program_t &p) {
-    int i = 0;
-    for (auto &light : m_values) {
-        if (light->m_shape) {
-            light->m_shape->get_transform().m_translation = light->m_position;
-        }
+} // namespace
 
-        const auto prefix = build_light_uniform_prefix(i++);
-        if (!light) {
-            p.set_uniform(prefix + "type", static_cast<int>(light_type_t::deactivated));
-            continue;
-        }
+light_manager_t::light_manager_t(opengl_cpp::gl_t &gl)
+    : m_gl(gl), m_light_factory(m_gl),
+      m_light_buffer(sizeof(shaders::light_block_t), configuration::uniform_block_lights),
+      m_cluster_grid(configuration::cluster_tiles_x, configuration::cluster_tiles_y, configuration::cluster_slices),
+      m_light_texels(GL_RGBA32F, configuration::texture_lights),
+      m_cluster_texels(GL_RG32UI, configuration::texture_clusters),
+      m_cluster_light_texels(GL_R32UI, configuration::texture_cluster_lights) {
+}
 
-        p.set_uniform(prefix + "position", light->m_position);
-        p.set_uniform(prefix + "ambient", light->m_ambient);
-        p.set_uniform(prefix + "diffuse", light->m_diffuse);
-        p.set_uniform(prefix + "specular", light->m_specular);
-        p.set_uniform(prefix + "attenuation_constant", light->m_attenuation_constant);
-        p.set_uniform(prefix + "attenuation_linear", light->m_attenuation_linear);
-        p.set_uniform(prefix + "attenuation_quadratic", light->m_attenuation_quadratic);
-
-        auto *direction_light = dynamic_cast<directional_light_t *>(light.get());
-        if (nullptr != direction_light) {
-            p.set_uniform(prefix + "type", static_cast<int>(light_type_t::directional));
-            p.set_uniform(prefix + "direction", direction_light->m_direction);
-        } else {
-            auto *spot_light = dynamic_cast<spot_light_t *>(light.get());
-            if (nullptr != spot_light) {
-                p.set_uniform(prefix + "type", static_cast<int>(light_type_t::spot));
-                p.set_uniform(prefix + "direction", spot_light->m_direction);
-                p.set_uniform(prefix + "cutoff_begin", glm::cos(glm::radians(spot_light->m_cutoff_begin)));
-                p.set_uniform(prefix + "cutoff_end", glm::cos(glm::radians(spot_light->m_cutoff_end)));
-            } else {
-                p.set_uniform(prefix + "type", static_cast<int>(light_type_t::ambient));
-            }
+void light_manager_t::update_light_block(const shaders::frame_block_t &frame_block) {
+    const auto &lights = m_lights.get_columns();
+    for (size_t slot = 0; slot < m_lights.size(); ++slot) {
+        if (lights.m_shape[slot]) {
+            lights.m_shape[slot]->get_transform().m_translation = lights.m_position[slot];
         }
     }
+
+    shaders::light_block_t block{};
+    const auto directional_first = m_lights.get_first(light_type_t::directional);
+    for (size_t i = 0; i < m_lights.get_count(light_type_t::directional); ++i) {
+        const auto slot = directional_first + i;
+        auto &packed = block.m_uniform_directional_light.at(i);
+        packed.m_type = static_cast<int32_t>(light_type_t::directional);
+        packed.m_direction = lights.m_direction[slot];
+        packed.m_ambient = lights.m_ambient[slot];
+        packed.m_diffuse = lights.m_diffuse[slot];
+        packed.m_specular = lights.m_specular[slot];
+        packed.m_attenuation_constant = lights.m_attenuation_constant[slot];
+        packed.m_attenuation_linear = lights.m_attenuation_linear[slot];
+        packed.m_attenuation_quadratic = lights.m_attenuation_quadratic[slot];
+    }
+
+    m_clustered_lights.clear();
+    m_light_spheres.clear();
+    pack_clustered_lights(light_type_t::ambient);
+    pack_clustered_lights(light_type_t::spot);
+
+    m_cluster_grid.update(frame_block.m_uniform_view, frame_block.m_uniform_projection, m_light_spheres.data(),
+                          m_light_spheres.size());
+    block.m_uniform_cluster.m_tiles_x = static_cast<int32_t>(m_cluster_grid.get_tiles_x());
+    block.m_uniform_cluster.m_tiles_y = static_cast<int32_t>(m_cluster_grid.get_tiles_y());
+    block.m_uniform_cluster.m_slices = static_cast<int32_t>(m_cluster_grid.get_slices());
+    block.m_uniform_cluster.m_depth_scale = m_cluster_grid.get_depth_scale();
+    block.m_uniform_cluster.m_depth_bias = m_cluster_grid.get_depth_bias();
+
+    // The block is padded and value-initialized, so a byte comparison tells whether anything changed.
+    if (!m_light_block_uploaded || 0 != std::memcmp(&block, &m_light_block, sizeof(block))) {
+        m_light_block = block;
+        m_light_buffer.update(0, sizeof(m_light_block), &m_light_block);
+        m_light_block_uploaded = true;
+    }
+
+    const auto &clusters = m_cluster_grid.get_clusters();
+    const auto &indices = m_cluster_grid.get_light_indices();
+    m_light_texels.update(m_clustered_lights.data(), m_clustered_lights.size() * sizeof(shaders::light_t));
+    m_cluster_texels.update(clusters.data(), clusters.size() * sizeof(cluster_grid_t::cluster_t));
+    m_cluster_light_texels.update(indices.data(), indices.size() * sizeof(uint32_t));
+    m_light_texels.bind();
+    m_cluster_texels.bind();
+    m_cluster_light_texels.bind();
+
+    m_statistics.m_clustered_lights = m_clustered_lights.size();
+    m_statistics.m_cluster_light_indices = indices.size();
+    m_statistics.m_max_cluster_lights = 0;
+    for (const auto &cluster : clusters) {
+        m_statistics.m_max_cluster_lights = std::max<size_t>(m_statistics.m_max_cluster_lights, cluster.m_count);
+    }
+}
+
+size_t light_manager_t::get_light_count(light_type_t type) const {
+    return m_lights.get_count(type);
+}
+
+const std::vector<glm::vec4> &light_manager_t::get_light_spheres() const {
+    return m_light_spheres;
 }
 
-light_manager_t::vector_t::iterator light_manager_t::begin() {
-    return m_values.begin();
+const light_manager_t::statistics_t &light_manager_t::get_statistics() const {
+    return m_statistics;
 }
 
-light_manager_t::vector_t::iterator light_manager_t::end() {
-    return m_values.end();
+light_t light_manager_t::build_light(light_type_t type) const {
+    return m_light_factory.build_light(type);
 }
 
-std::string light_manager_t::build_light_uniform_prefix(int i) {
-    return "uniform_light[" + std::to_string(i) + "].";
+light_manager_t::handle_t light_manager_t::add_light(const light_t &light) {
+    const auto directional = light_type_t::directional == light.m_type;
+    const auto count = directional ? m_lights.get_count(light_type_t::directional)
+                                   : m_lights.get_count(light_type_t::ambient) + m_lights.get_count(light_type_t::spot);
+    if (count >= (directional ? configuration::directional_light_max : configuration::light_max)) {
+        return light_store_t::m_invalid_handle;
+    }
+    return m_lights.add(light);
+}
+
+light_t light_manager_t::get_light(handle_t handle) const {
+    return m_lights.get(handle);
+}
+
+void light_manager_t::set_light(handle_t handle, const light_t &light) {
+    m_lights.set(handle, light);
+}
+
+const std::vector<light_manager_t::handle_t> &light_manager_t::get_handles() const {
+    return m_lights.get_handles();
+}
+
+void light_manager_t::pack_clustered_lights(light_type_t type) {
+    const auto &lights = m_lights.get_columns();
+    const auto first = m_lights.get_first(type);
+    const auto count = m_lights.get_count(type);
+    const auto base = m_clustered_lights.size();
+    m_clustered_lights.resize(base + count);
+    m_light_spheres.resize(base + count);
+
+    // Each pass reads a few parameter arrays from start to end, the type only decides which passes run.
+    for (size_t i = 0; i < count; ++i) {
+        auto &packed = m_clustered_lights[base + i];
+        packed = {};
+        packed.m_type = texel_type(type);
+        packed.m_position = lights.m_position[first + i];
+        packed.m_ambient = lights.m_ambient[first + i];
+        packed.m_diffuse = lights.m_diffuse[first + i];
+        packed.m_specular = lights.m_specular[first + i];
+        packed.m_attenuation_constant = lights.m_attenuation_constant[first + i];
+        packed.m_attenuation_linear = lights.m_attenuation_linear[first + i];
+        packed.m_attenuation_quadratic = lights.m_attenuation_quadratic[first + i];
+    }
+
+    // The threshold applies to the brightest channel the light can add, so dim lights get smaller bounds.
+    for (size_t i = 0; i < count; ++i) {
+        const auto color = lights.m_ambient[first + i] + lights.m_diffuse[first + i] + lights.m_specular[first + i];
+        const auto brightness = std::max({color.x, color.y, color.z});
+        const auto radius =
+            brightness > 0.0F ? attenuation_radius(lights.m_attenuation_constant[first + i],
+                                                   lights.m_attenuation_linear[first + i],
+                                                   lights.m_attenuation_quadratic[first + i],
+                                                   configuration::light_attenuation_threshold / brightness)
+                              : 0.0F;
+        m_light_spheres[base + i] = glm::vec4(lights.m_position[first + i], radius);
+    }
+
+    if (light_type_t::spot != type) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        auto &packed = m_clustered_lights[base + i];
+        // Spot lights without a direction point down rather than spreading NaNs.
+        const auto length = glm::length(lights.m_direction[first + i]);
+        packed.m_direction = length > 0.0F ? lights.m_direction[first + i] / length : glm::vec3(0.0F, -1.0F, 0.0F);
+        packed.m_cutoff_begin = glm::cos(glm::radians(lights.m_cutoff_begin[first + i]));
+        packed.m_cutoff_end = glm::cos(glm::radians(lights.m_cutoff_end[first + i]));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const auto &packed = m_clustered_lights[base + i];
+        auto &sphere = m_light_spheres[base + i];
+        sphere = spot_bounding_sphere(packed.m_position, packed.m_direction, sphere.w, packed.m_cutoff_end);
+    }
 }
 
 } // namespace game_engine
@@ -1,35 +1,113 @@
 #pragma once
 
+#include "data_types/texture_buffer.h"
+#include "data_types/uniform_buffer.h"
 #include "factories/light_factory.h"
+#include "generated/shader_layout.h"
+#include "utils/cluster_grid.h"
 #include "utils/configuration.h"
+#include "utils/light_store.h"
+#include <vector>
 
 namespace game_engine {
 
+static_assert(shaders::directional_light_max == configuration::directional_light_max,
+              "DIRECTIONAL_LIGHT_MAX in object.frag must match configuration::directional_light_max");
+static_assert(sizeof(shaders::light_t) == shaders::light_texels * sizeof(glm::vec4),
+              "LIGHT_TEXELS in object.frag must match the size of shaders::light_t");
+static_assert(shaders::light_deactivated == static_cast<int>(light_type_t::deactivated) &&
+                  shaders::light_ambient == static_cast<int>(light_type_t::ambient) &&
+                  shaders::light_directional == static_cast<int>(light_type_t::directional) &&
+                  shaders::light_spot == static_cast<int>(light_type_t::spot),
+              "light types in object.frag must match light_type_t");
+
 class light_manager_t {
   public:
-    using vector_t = std::vector<light_pointer_t>;
+    using handle_t = light_store_t::handle_t;
 
     light_manager_t(opengl_cpp::gl_t &gl);
 
-    void update_light_uniforms(opengl_cpp::program_t &p);
-    vector_t::iterator begin();
-    vector_t::iterator end();
+    struct statistics_t {
+        size_t m_clustered_lights{};
+        size_t m_cluster_light_indices{};
+        size_t m_max_cluster_lights{};
+    };
+
+    /**
+     * @brief Packs the directional lights into the light uniform block, and assigns the point and spot lights to the
+     * clusters of the view through their attenuation radius and cone. Both are uploaded and bound for drawing. Meant
+     * to be called once per frame, once the frame block is up to date.
+     * @param frame_block Frame uniforms, whose view and projection the clusters are built from.
+     */
+    void update_light_block(const shaders::frame_block_t &frame_block);
+
+    /**
+     * @brief Gets the number of lights of a type.
+     * @param type Light type.
+     */
+    [[nodiscard]] size_t get_light_count(light_type_t type) const;
+
+    /**
+     * @brief Gets the world-space bounding spheres of the point and spot lights packed by the last
+     * update_light_block() call, as center and radius, in the order the shaders index them.
+     */
+    [[nodiscard]] const std::vector<glm::vec4> &get_light_spheres() const;
+
+    [[nodiscard]] const statistics_t &get_statistics() const;
 
-    template <class light_template_t> light_template_t *add_light() {
-        if (m_values.size() >= configuration::light_count) {
-            return nullptr;
-        }
+    /**
+     * @brief Creates a light with the default parameters of its type, to be passed to add_light().
+     * @param type Light type.
+     */
+    [[nodiscard]] light_t build_light(light_type_t type) const;
 
-        auto ret = m_values.emplace_back(m_light_factory.build_light(light_template_t::m_type));
-        return dynamic_cast<light_template_t *>(ret.get());
-    }
+    /**
+     * @brief Adds a light. Directional lights light every fragment, so only a few fit; the others are limited by the
+     * cluster buffers.
+     * @param light Light parameters.
+     * @return Handle of the light, or light_store_t::m_invalid_handle past the limit of its type.
+     */
+    handle_t add_light(const light_t &light);
+
+    /**
+     * @brief Gathers the parameters of a light.
+     * @param handle Handle returned by add_light().
+     */
+    [[nodiscard]] light_t get_light(handle_t handle) const;
+
+    /**
+     * @brief Replaces the parameters of a light, except its type.
+     * @param handle Handle returned by add_light().
+     * @param light Light parameters.
+     */
+    void set_light(handle_t handle, const light_t &light);
+
+    /**
+     * @brief Gets the handles of the lights, grouped by type.
+     */
+    [[nodiscard]] const std::vector<handle_t> &get_handles() const;
 
   private:
     opengl_cpp::gl_t &m_gl;
-    vector_t m_values;
+    light_store_t m_lights;
     light_factory_t m_light_factory;
+    uniform_buffer_t m_light_buffer;
+    shaders::light_block_t m_light_block{};
+    bool m_light_block_uploaded{false};
+
+    cluster_grid_t m_cluster_grid;
+    texture_buffer_t m_light_texels;
+    texture_buffer_t m_cluster_texels;
+    texture_buffer_t m_cluster_light_texels;
+    std::vector<shaders::light_t> m_clustered_lights;
+    std::vector<glm::vec4> m_light_spheres;
+    statistics_t m_statistics;
 
-    std::string build_light_uniform_prefix(int i);
+    /**
+     * @brief Appends the point or spot lights to the clustered lights and their bounding spheres.
+     * @param type light_type_t::ambient or light_type_t::spot.
+     */
+    void pack_clustered_lights(light_type_t type);
 };
 
 } // namespace game_engine
@@ -1,18 +1,30 @@
 #include "shape_manager.h"
 
+#include "data_types/shape.h"
+#include "utils/configuration.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
 namespace game_engine {
 
 shape_manager_t::shape_manager_t(opengl_cpp::gl_t &gl)
-    : m_gl(gl), m_program_factory(m_gl), m_object_program(m_program_factory.build_object_program()),
-      m_light_program(m_program_factory.build_light_program()) {
+    : m_gl(gl), m_program_factory(m_gl), m_light_program(m_program_factory.build_light_program()),
+      m_object_lights(configuration::object_light_max),
+      m_occlusion_buffer(configuration::occlusion_buffer_width, configuration::occlusion_buffer_height),
+      m_static_batch(m_gl), m_static_group_lights(configuration::object_light_max) {
 }
 
 void shape_manager_t::add_object_shape(shape_pointer_t shape) {
-    add_shape(std::move(shape), m_object_program);
+    add_shape(std::move(shape), m_program_factory.build_object_program({}), false);
 }
 
 void shape_manager_t::add_light_shape(shape_pointer_t shape) {
-    add_shape(std::move(shape), m_light_program);
+    add_shape(std::move(shape), m_light_program, false);
+}
+
+void shape_manager_t::add_static_shape(shape_pointer_t shape) {
+    add_shape(std::move(shape), m_program_factory.build_object_program({}), true);
 }
 
 std::vector<shape_manager_t::pair_t>::iterator shape_manager_t::begin() {
@@ -23,12 +35,232 @@ std::vector<shape_manager_t::pair_t>::iterator shape_manager_t::end() {
     return m_values.end();
 }
 
-void shape_manager_t::add_shape(shape_pointer_t shape, program_pointer_t program) {
+void shape_manager_t::update_static_batch() {
+    // Shapes moved or restyled since they were merged are drawn on their own from now on.
+    for (size_t member = 0; member < m_static_members.size(); ++member) {
+        if (m_static_batch.is_stale(member)) {
+            m_static[m_static_members[member]] = false;
+            m_static_batch_dirty = true;
+        }
+    }
+    if (!m_static_batch_dirty) {
+        return;
+    }
+
+    m_static_members.clear();
+    std::vector<shape_t *> shapes;
+    for (size_t i = 0; i < m_values.size(); ++i) {
+        if (m_static[i]) {
+            m_static_members.emplace_back(i);
+            shapes.emplace_back(m_values[i].second.get());
+        }
+    }
+    m_static_batch.build(shapes);
+
+    m_static_groups.assign(m_values.size(), std::numeric_limits<size_t>::max());
+    for (size_t member = 0; member < m_static_members.size(); ++member) {
+        m_static_groups[m_static_members[member]] = m_static_batch.get_group(member);
+    }
+    m_static_group_values.clear();
+    m_static_group_bvh = {};
+    for (const auto &group : m_static_batch.get_groups()) {
+        m_static_group_values.emplace_back(m_program_factory.build_object_program({}), group);
+        m_static_group_bvh.insert(group->world_bounds());
+    }
+    m_static_group_bvh.update();
+    m_static_batch_dirty = false;
+}
+
+void shape_manager_t::select_programs(const program_features_t &frame_features) {
+    for (const auto &replacement : m_program_factory.update()) {
+        for (auto *values : {&m_values, &m_static_group_values}) {
+            for (auto &value : *values) {
+                if (value.first == replacement.m_previous) {
+                    value.first = replacement.m_current;
+                }
+            }
+        }
+        if (m_light_program == replacement.m_previous) {
+            m_light_program = replacement.m_current;
+        }
+    }
+
+    for (auto &value : m_values) {
+        if (value.first != m_light_program) {
+            select_program(value, frame_features);
+        }
+    }
+    for (auto &value : m_static_group_values) {
+        select_program(value, frame_features);
+    }
+}
+
+void shape_manager_t::update_bounds() {
+    for (uint32_t i = 0; i < m_values.size(); ++i) {
+        m_bvh.move(i, m_values[i].second->world_bounds());
+    }
+    m_bvh.update();
+}
+
+void shape_manager_t::update_lights(const std::vector<glm::vec4> &spheres) {
+    m_object_lights.update(m_bvh, m_values.size(), spheres.data(), spheres.size());
+    m_static_group_lights.update(m_static_group_bvh, m_static_group_values.size(), spheres.data(), spheres.size());
+}
+
+object_lights_t::list_t shape_manager_t::get_lights(const pair_t &pair) const {
+    if (&pair >= m_static_group_values.data() && &pair < m_static_group_values.data() + m_static_group_values.size()) {
+        return m_static_group_lights.get_lights(static_cast<uint32_t>(&pair - m_static_group_values.data()));
+    }
+    return m_object_lights.get_lights(static_cast<uint32_t>(&pair - m_values.data()));
+}
+
+void shape_manager_t::query_frustum(const frustum_t &frustum, std::vector<pair_t *> &ret) {
+    m_query_scratch.clear();
+    m_bvh.query_frustum(frustum, m_query_scratch);
+
+    ret.clear();
+    for (const auto handle : m_query_scratch) {
+        ret.emplace_back(&m_values[handle]);
+    }
+}
+
+void shape_manager_t::query_sphere(const glm::vec3 &center, float radius, std::vector<pair_t *> &ret) {
+    m_query_scratch.clear();
+    m_bvh.query_sphere(center, radius, m_query_scratch);
+
+    ret.clear();
+    for (const auto handle : m_query_scratch) {
+        ret.emplace_back(&m_values[handle]);
+    }
+}
+
+void shape_manager_t::cull_occluded(const glm::mat4 &view_projection, const glm::vec3 &view_position,
+                                    std::vector<pair_t *> &visible) {
+    m_occlusion_buffer.clear();
+
+    // Bounds radius over distance approximates how much of the screen a shape covers.
+    m_occluder_scratch.clear();
+    for (auto *pair : visible) {
+        const auto &mesh = pair->second->get_mesh();
+        if (mesh.get_triangle_indices().size() / 3 > configuration::occluder_max_triangles) {
+            continue;
+        }
+        const auto &bounds = pair->second->world_bounds();
+        const auto distance =
+            std::max(glm::distance(bounds.get_center(), view_position), configuration::camera_clipping_near);
+        m_occluder_scratch.emplace_back(glm::length(bounds.get_extents()) / distance, pair);
+    }
+
+    const auto occluder_count = std::min(m_occluder_scratch.size(), configuration::occluder_count);
+    std::partial_sort(m_occluder_scratch.begin(), m_occluder_scratch.begin() + occluder_count, m_occluder_scratch.end(),
+                      [](const auto &lhs, const auto &rhs) { return lhs.first > rhs.first; });
+    m_occluder_scratch.resize(occluder_count);
+
+    for (const auto &occluder : m_occluder_scratch) {
+        auto &shape = *occluder.second->second;
+        const auto &mesh = shape.get_mesh();
+        m_occlusion_buffer.rasterize(view_projection * shape.model_transformations(), mesh.get_positions().data(),
+                                     mesh.get_triangle_indices().data(), mesh.get_triangle_indices().size());
+    }
+
+    // Occluders are kept without testing: their own conservative depth may sit just behind their bounds.
+    const auto is_occluder = [&](const pair_t *pair) {
+        return m_occluder_scratch.end() !=
+               std::find_if(m_occluder_scratch.begin(), m_occluder_scratch.end(),
+                            [&](const auto &occluder) { return occluder.second == pair; });
+    };
+    visible.erase(std::remove_if(visible.begin(), visible.end(),
+                                 [&](pair_t *pair) {
+                                     return !is_occluder(pair) &&
+                                            !m_occlusion_buffer.is_visible(pair->second->world_bounds(),
+                                                                           view_projection);
+                                 }),
+                  visible.end());
+}
+
+void shape_manager_t::build_draw_list(const std::vector<pair_t *> &visible, std::vector<pair_t *> &ret) {
+    ret.clear();
+    m_static_group_visible.assign(m_static_group_values.size(), false);
+    for (auto *pair : visible) {
+        const auto index = static_cast<size_t>(pair - m_values.data());
+        if (index < m_static_groups.size() && m_static_groups[index] < m_static_group_visible.size()) {
+            m_static_group_visible[m_static_groups[index]] = true;
+        } else {
+            ret.emplace_back(pair);
+        }
+    }
+    for (size_t group = 0; group < m_static_group_values.size(); ++group) {
+        if (m_static_group_visible[group]) {
+            ret.emplace_back(&m_static_group_values[group]);
+        }
+    }
+}
+
+shape_manager_t::pair_t *shape_manager_t::pick(const ray_t &ray, float max_distance) {
+    pair_t *ret = nullptr;
+    m_bvh.query_ray(ray.m_origin, ray.m_direction, max_distance, [&](uint32_t handle) {
+        // The hierarchy only reports hits closer than the best one so far, so the last shape reporting one wins.
+        auto &pair = m_values[handle];
+        const auto hit = pair.second->intersect(ray, max_distance);
+        if (hit >= 0.0F && hit <= max_distance) {
+            max_distance = hit;
+            ret = &pair;
+        }
+        return hit;
+    });
+    return ret;
+}
+
+size_t shape_manager_t::size() const {
+    return m_values.size();
+}
+
+const object_lights_t &shape_manager_t::get_object_lights() const {
+    return m_object_lights;
+}
+
+const occlusion_buffer_t &shape_manager_t::get_occlusion_buffer() const {
+    return m_occlusion_buffer;
+}
+
+const static_batch_t &shape_manager_t::get_static_batch() const {
+    return m_static_batch;
+}
+
+const bvh_t &shape_manager_t::get_bvh() const {
+    return m_bvh;
+}
+
+std::vector<program_pointer_t> shape_manager_t::get_programs() const {
+    return m_program_factory.get_programs();
+}
+
+const program_factory_t &shape_manager_t::get_program_factory() const {
+    return m_program_factory;
+}
+
+void shape_manager_t::add_shape(shape_pointer_t shape, program_pointer_t program, bool is_static) {
     auto find = std::find_if(m_values.begin(), m_values.end(), [&](pair_t &v) {
         return v.second == shape;
     });
     if (m_values.end() == find) {
+        [[maybe_unused]] const auto handle = m_bvh.insert(shape->world_bounds());
+        assert(handle == m_values.size());
         m_values.emplace_back(std::make_pair(std::move(program), std::move(shape)));
+        m_static.push_back(is_static);
+        m_static_batch_dirty = m_static_batch_dirty || is_static;
+    }
+}
+
+void shape_manager_t::select_program(pair_t &value, const program_features_t &frame_features) {
+    assert(value.second);
+    const auto &material = value.second->get_material();
+    auto features = frame_features;
+    features.m_diffuse_map = static_cast<bool>(material.m_diffuse);
+    features.m_specular_map = static_cast<bool>(material.m_specular);
+    auto program = m_program_factory.build_object_program(features);
+    if (program->is_ready() || !value.first->is_ready()) {
+        value.first = std::move(program);
     }
 }
 } // namespace game_engine
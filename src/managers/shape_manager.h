@@ -1,7 +1,14 @@
 #pragma once
 
+#include "data_types/static_batch.h"
 #include "data_types/types.h"
 #include "factories/program_factory.h"
+#include "utils/bvh.h"
+#include "utils/frustum.h"
+#include "utils/object_lights.h"
+#include "utils/occlusion_buffer.h"
+#include "utils/ray.h"
+#include <vector>
 
 namespace game_engine {
 
@@ -15,18 +22,130 @@ class shape_manager_t {
     void add_object_shape(shape_pointer_t shape);
     void add_light_shape(shape_pointer_t shape);
 
+    /**
+     * @brief Adds an object shape that is not meant to move, drawn from the static batch rather than on its own. If
+     * its transform or material changes anyway, it goes back to being drawn like other object shapes.
+     * @param shape Shape to add.
+     */
+    void add_static_shape(shape_pointer_t shape);
+
     vector_t::iterator begin();
     vector_t::iterator end();
 
+    /**
+     * @brief Merges the static shapes into the static batch if any were added, moved or restyled since the last
+     * merge; the latter two are no longer treated as static. Meant to be called once per frame, before
+     * select_programs().
+     */
+    void update_static_batch();
+
+    /**
+     * @brief Picks the object program variant of every object shape from its material and the frame-wide features.
+     * Variants are compiled on first use and cached. Shapes keep their previous variant until the new one is ready,
+     * so switching features never stalls. Programs recompiled after their sources changed are swapped in here, so a
+     * frame never mixes both. Meant to be called once per frame, before drawing.
+     * @param frame_features Features shared by every object shape in the frame. Material features are ignored.
+     */
+    void select_programs(const program_features_t &frame_features);
+
+    /**
+     * @brief Brings the bounding volume hierarchy up to date with the shapes' current transforms. Meant to be called
+     * once per frame, before querying.
+     */
+    void update_bounds();
+
+    /**
+     * @brief Brings the lists of lights overlapping each shape up to date, for the shapes or lights that moved since
+     * the last call. Meant to be called once per frame, after update_bounds().
+     * @param spheres World-space bounding spheres of the lights, as indexed by the shaders.
+     */
+    void update_lights(const std::vector<glm::vec4> &spheres);
+
+    /**
+     * @brief Gets the lights overlapping a shape, as of the last update_lights().
+     * @param pair Shape, as returned by the queries or build_draw_list().
+     */
+    [[nodiscard]] object_lights_t::list_t get_lights(const pair_t &pair) const;
+
+    /**
+     * @brief Collects the shapes whose bounds are at least partially inside a frustum.
+     * @param frustum View frustum.
+     * @param ret Receives the shapes, replacing its contents.
+     */
+    void query_frustum(const frustum_t &frustum, std::vector<pair_t *> &ret);
+
+    /**
+     * @brief Collects the shapes whose bounds overlap a sphere.
+     * @param center Sphere center.
+     * @param radius Sphere radius.
+     * @param ret Receives the shapes, replacing its contents.
+     */
+    void query_sphere(const glm::vec3 &center, float radius, std::vector<pair_t *> &ret);
+
+    /**
+     * @brief Drops the shapes hidden behind others. The shapes that look largest from the view position, among those
+     * with few enough triangles, are rasterized into the occlusion buffer, and the bounds of the rest are tested
+     * against it.
+     * @param view_projection Projection matrix times view matrix.
+     * @param view_position Camera position.
+     * @param visible Shapes to test, typically those inside the view frustum. Hidden ones are removed in place.
+     */
+    void cull_occluded(const glm::mat4 &view_projection, const glm::vec3 &view_position,
+                       std::vector<pair_t *> &visible);
+
+    /**
+     * @brief Builds the list of shapes to draw from the visible ones, static shapes being replaced by the groups of
+     * the static batch holding them. A group is drawn whole as soon as one of its shapes is visible.
+     * @param visible Visible shapes, as returned by query_frustum() and cull_occluded().
+     * @param ret Receives the shapes to draw, replacing its contents.
+     */
+    void build_draw_list(const std::vector<pair_t *> &visible, std::vector<pair_t *> &ret);
+
+    /**
+     * @brief Finds the shape whose triangles a ray hits first. Only shapes whose bounds the ray hits closer than the
+     * best hit so far are tested against their triangles.
+     * @param ray Ray, in world space.
+     * @param max_distance Distance past which hits are ignored.
+     * @return Shape hit, or nullptr if there is none.
+     */
+    [[nodiscard]] pair_t *pick(const ray_t &ray, float max_distance);
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] const bvh_t &get_bvh() const;
+    [[nodiscard]] const object_lights_t &get_object_lights() const;
+    [[nodiscard]] const occlusion_buffer_t &get_occlusion_buffer() const;
+    [[nodiscard]] const static_batch_t &get_static_batch() const;
+    [[nodiscard]] std::vector<program_pointer_t> get_programs() const;
+    [[nodiscard]] const program_factory_t &get_program_factory() const;
+
   private:
     opengl_cpp::gl_t &m_gl;
     program_factory_t m_program_factory;
 
     vector_t m_values;
-    program_pointer_t m_object_program;
     program_pointer_t m_light_program;
 
-    void add_shape(shape_pointer_t shape, program_pointer_t program);
+    // Shapes are never removed, so the handle of each one is its index in m_values.
+    bvh_t m_bvh;
+    std::vector<uint32_t> m_query_scratch;
+    object_lights_t m_object_lights;
+
+    occlusion_buffer_t m_occlusion_buffer;
+    std::vector<std::pair<float, pair_t *>> m_occluder_scratch;
+
+    // Indexed like m_values: whether each shape is meant to be static, and the group of the static batch drawing it.
+    std::vector<bool> m_static;
+    std::vector<size_t> m_static_groups;
+    static_batch_t m_static_batch;
+    std::vector<size_t> m_static_members;
+    vector_t m_static_group_values;
+    bvh_t m_static_group_bvh;
+    object_lights_t m_static_group_lights;
+    std::vector<bool> m_static_group_visible;
+    bool m_static_batch_dirty{false};
+
+    void add_shape(shape_pointer_t shape, program_pointer_t program, bool is_static);
+    void select_program(pair_t &value, const program_features_t &frame_features);
 };
 
 } // namespace game_engine
@@ -1,15 +1,99 @@
 #include "renderer.h"
 
-#include "data_types/shape.h"
+#include <cstring>
+#include <glad/glad.h>
+#include <limits>
 
 namespace game_engine {
 
-renderer_t::renderer_t(opengl_cpp::gl_t &gl) : m_gl(gl) {
+namespace {
+
+/**
+ * @brief Numbers the states met in a frame densely, in submission order, so they fit the sort key fields.
+ */
+template <class map_t, class key_t> uint32_t get_state_id(map_t &ids, const key_t &key) {
+    return ids.emplace(key, static_cast<uint32_t>(ids.size())).first->second;
 }
 
-void renderer_t::draw(shape_t &s) {
-    s.bind();
-    m_gl.draw_arrays(0, s.get_mesh().get_vertices().size());
+} // namespace
+
+renderer_t::renderer_t(opengl_cpp::gl_t &gl, texture_residency_t &texture_residency)
+    : m_gl(gl), m_texture_residency(texture_residency),
+      m_frame_buffer(sizeof(shaders::frame_block_t), configuration::uniform_block_frame),
+      m_object_light_texels(GL_R32UI, configuration::texture_object_lights) {
+}
+
+void renderer_t::submit(program_t &program, shape_t &shape, const object_lights_t::list_t &lights) {
+    const auto &material = shape.get_material();
+    const std::array<const void *, configuration::texture_unit_count> textures = {
+        material.m_texture1.get(), material.m_texture2.get(), material.m_diffuse.get(), material.m_specular.get()};
+
+    const auto program_id = get_state_id(m_program_ids, &program);
+    const auto material_id = get_state_id(m_material_ids, textures);
+    const auto vertex_array_id = get_state_id(m_vertex_array_ids, &shape.get_vertex_array());
+
+    const auto key = render_queue_t::make_key(program_id, material_id, vertex_array_id, get_depth(shape));
+    m_draws.push_back({&program, &shape, lights, material_id, key});
+}
+
+void renderer_t::flush() {
+    m_statistics = {};
+    for (size_t i = 0; i < m_draws.size(); ++i) {
+        m_queue.push(m_draws[i].m_key, static_cast<uint32_t>(i));
+    }
+    m_queue.sort();
+    build_batches();
+    m_instance_buffer.update(m_instances);
+    m_object_light_texels.update(m_object_lights.data(), m_object_lights.size() * sizeof(uint32_t));
+    m_object_light_texels.bind();
+    m_statistics.m_instances = m_instances.size();
+    m_statistics.m_object_lights = m_object_lights.size();
+
+    // Tracked by object rather than by key field, which stays correct if the identifiers were clamped.
+    const program_t *program = nullptr;
+    auto material = std::numeric_limits<uint32_t>::max();
+    const opengl_cpp::vertex_array_t *vertex_array = nullptr;
+    for (const auto &batch : m_batches) {
+        const auto &draw = *batch.m_draw;
+        auto &shape = *draw.m_shape;
+
+        if (program != draw.m_program) {
+            draw.m_program->use();
+            set_sampler_uniforms(*draw.m_program);
+            program = draw.m_program;
+            ++m_statistics.m_state_changes;
+        } else {
+            ++m_statistics.m_avoided_state_changes;
+        }
+
+        if (material != draw.m_material) {
+            shape.bind_textures(m_bound_textures, m_texture_residency);
+            material = draw.m_material;
+            ++m_statistics.m_state_changes;
+        } else {
+            ++m_statistics.m_avoided_state_changes;
+        }
+
+        if (vertex_array != &shape.get_vertex_array()) {
+            shape.bind_vertex_array();
+            vertex_array = &shape.get_vertex_array();
+            ++m_statistics.m_state_changes;
+        } else {
+            ++m_statistics.m_avoided_state_changes;
+        }
+
+        m_instance_buffer.bind_attributes(batch.m_first_instance);
+        glDrawArraysInstanced(GL_TRIANGLES, static_cast<GLint>(shape.get_first_vertex()),
+                              static_cast<GLsizei>(shape.get_vertex_count()),
+                              static_cast<GLsizei>(batch.m_instance_count));
+        ++m_statistics.m_draws;
+    }
+
+    m_queue.clear();
+    m_draws.clear();
+    m_program_ids.clear();
+    m_material_ids.clear();
+    m_vertex_array_ids.clear();
 }
 
 void renderer_t::set_viewport(size_t width, size_t height) {
@@ -37,7 +121,86 @@ void renderer_t::set_clear_color(const glm::vec4 &c) {
 }
 
 void renderer_t::clear() {
+    m_bound_textures.fill(nullptr);
     m_gl.clear();
 }
 
+void renderer_t::update_frame_block(const shaders::frame_block_t &frame_block) {
+    if (m_frame_block_uploaded && 0 == std::memcmp(&frame_block, &m_frame_block, sizeof(frame_block))) {
+        return;
+    }
+
+    m_frame_block = frame_block;
+    m_frame_buffer.update(0, sizeof(m_frame_block), &m_frame_block);
+    m_frame_block_uploaded = true;
+}
+
+const shaders::frame_block_t &renderer_t::get_frame_block() const {
+    return m_frame_block;
+}
+
+const renderer_t::statistics_t &renderer_t::get_statistics() const {
+    return m_statistics;
+}
+
+float renderer_t::get_depth(const shape_t &shape) const {
+    const auto far = m_frame_block.m_uniform_depth.m_far;
+    const auto position = glm::vec3(shape.model_transformations()[3]);
+    return far > 0.0F ? glm::distance(position, m_frame_block.m_uniform_view_pos) / far : 0.0F;
+}
+
+void renderer_t::build_batches() {
+    m_batches.clear();
+    m_instances.clear();
+    m_object_lights.clear();
+
+    // Sorting put draws sharing all state next to each other, so each batch is a run of the queue. Shapes sharing a
+    // vertex array may still draw different ranges of it, which only instances of the same range can share.
+    for (const auto &item : m_queue.get_items()) {
+        const auto &draw = m_draws.at(item.m_index);
+        if (m_batches.empty() || m_batches.back().m_draw->m_program != draw.m_program ||
+            m_batches.back().m_draw->m_material != draw.m_material ||
+            &m_batches.back().m_draw->m_shape->get_vertex_array() != &draw.m_shape->get_vertex_array() ||
+            m_batches.back().m_draw->m_shape->get_first_vertex() != draw.m_shape->get_first_vertex() ||
+            m_batches.back().m_draw->m_shape->get_vertex_count() != draw.m_shape->get_vertex_count()) {
+            m_batches.push_back({&draw, m_instances.size(), 0});
+        }
+        m_instances.emplace_back(make_instance(draw));
+        ++m_batches.back().m_instance_count;
+    }
+}
+
+void renderer_t::set_sampler_uniforms(program_t &program) {
+    program.set(shaders::uniform_material_texture1, configuration::texture_layer_1);
+    program.set(shaders::uniform_material_texture2, configuration::texture_layer_2);
+    program.set(shaders::uniform_material_diffuse, configuration::texture_diffuse);
+    program.set(shaders::uniform_material_specular, configuration::texture_specular);
+    program.set(shaders::uniform_lights, configuration::texture_lights);
+    program.set(shaders::uniform_clusters, configuration::texture_clusters);
+    program.set(shaders::uniform_cluster_lights, configuration::texture_cluster_lights);
+    program.set(shaders::uniform_object_lights, configuration::texture_object_lights);
+}
+
+instance_t renderer_t::make_instance(const draw_t &draw) {
+    auto &shape = *draw.m_shape;
+    const auto &material = shape.get_material();
+
+    instance_t ret;
+    ret.m_model = shape.model_transformations();
+    ret.m_normal_matrix = shape.normal_matrix();
+    ret.m_material = glm::vec4(material.m_ambient, material.m_shininess);
+    ret.m_material_texture = glm::vec2(static_cast<float>(material.m_texture2_layer), material.m_texture_mix);
+
+    ret.m_light_offset = static_cast<uint32_t>(m_object_lights.size());
+    if (draw.m_lights.m_overflow) {
+        ret.m_light_count = std::numeric_limits<uint32_t>::max();
+        ++m_statistics.m_object_light_overflows;
+    } else {
+        m_object_lights.insert(m_object_lights.end(), draw.m_lights.m_lights,
+                               draw.m_lights.m_lights + draw.m_lights.m_count);
+        ret.m_light_count = static_cast<uint32_t>(draw.m_lights.m_count);
+    }
+    return ret;
+}
+
 } // namespace game_engine
@@ -1,20 +1,52 @@
 #pragma once
 
+#include "data_types/instance_buffer.h"
+#include "data_types/program.h"
+#include "data_types/shape.h"
+#include "data_types/texture_buffer.h"
+#include "data_types/uniform_buffer.h"
+#include "generated/shader_layout.h"
+#include "utils/object_lights.h"
+#include "utils/render_queue.h"
+#include <array>
+#include <cstdint>
+#include <map>
 #include <opengl-cpp/backend/gl.h>
+#include <unordered_map>
+#include <vector>
 
 namespace game_engine {
 
-class shape_t;
-
 class renderer_t {
   public:
-    renderer_t(opengl_cpp::gl_t &gl);
+    struct statistics_t {
+        size_t m_draws{};
+        size_t m_instances{};
+        size_t m_state_changes{};
+        size_t m_avoided_state_changes{};
+        size_t m_object_lights{};
+        size_t m_object_light_overflows{};
+    };
+
+    renderer_t(opengl_cpp::gl_t &gl, texture_residency_t &texture_residency);
+
+    /**
+     * @brief Queues a shape to be drawn on the next flush(). Both the program and the shape must outlive the flush.
+     * Shapes are ordered front to back from the camera of the last update_frame_block(), so call that first.
+     * @param program Linked program to draw the shape with.
+     * @param shape Shape to be drawn.
+     * @param lights Lights affecting the shape, which must stay valid until the flush. Shapes reached by more than
+     * configuration::object_light_max lights overflow and are left to the light clusters.
+     */
+    void submit(program_t &program, shape_t &shape, const object_lights_t::list_t &lights);
 
     /**
-     * @brief Draws a shape in the current viewport.
-     * @param s Shape to be drawn.
+     * @brief Draws the queued shapes in the current viewport, sorted by state, so programs, texture sets and vertex
+     * arrays are only switched between draws that differ in them. Shapes sharing all three are drawn with a single
+     * instanced call, their transforms and material parameters read from per-instance attributes. Meant to be called
+     * once per frame.
      */
-    void draw(shape_t &s);
+    void flush();
 
     /**
      * @brief Sets the dimensions of the window viewport.
@@ -42,12 +74,69 @@ class renderer_t {
     void set_clear_color(const glm::vec4 &c);
 
     /**
-     * @brief Clears the current viewport.
+     * @brief Clears the current viewport. Also forgets the tracked texture bindings, as other code (e.g. the UI) may
+     * have rebound the texture units since the last frame.
      */
     void clear();
 
+    /**
+     * @brief Uploads the per-frame constants, unless they are identical to the last ones uploaded. Meant to be called
+     * once per frame, before drawing.
+     * @param frame_block Camera and depth parameters of the frame.
+     */
+    void update_frame_block(const shaders::frame_block_t &frame_block);
+
+    /**
+     * @brief Gets the per-frame constants last uploaded.
+     */
+    [[nodiscard]] const shaders::frame_block_t &get_frame_block() const;
+
+    /**
+     * @brief Gets the counters of the last flush. Each instanced draw either switches or keeps its program, texture
+     * set and vertex array. Each instance either lists the lights affecting it or overflows.
+     */
+    [[nodiscard]] const statistics_t &get_statistics() const;
+
   private:
+    struct draw_t {
+        program_t *m_program;
+        shape_t *m_shape;
+        object_lights_t::list_t m_lights;
+        uint32_t m_material;
+        uint64_t m_key;
+    };
+
+    struct batch_t {
+        const draw_t *m_draw;
+        size_t m_first_instance;
+        size_t m_instance_count;
+    };
+
     opengl_cpp::gl_t &m_gl;
+    texture_residency_t &m_texture_residency;
+    bound_textures_t m_bound_textures{};
+    uniform_buffer_t m_frame_buffer;
+    shaders::frame_block_t m_frame_block{};
+    bool m_frame_block_uploaded{false};
+
+    render_queue_t m_queue;
+    std::vector<draw_t> m_draws;
+    std::vector<batch_t> m_batches;
+    std::vector<instance_t> m_instances;
+    instance_buffer_t m_instance_buffer;
+    std::vector<uint32_t> m_object_lights;
+    texture_buffer_t m_object_light_texels;
+    std::unordered_map<const void *, uint32_t> m_program_ids;
+    std::map<std::array<const void *, configuration::texture_unit_count>, uint32_t> m_material_ids;
+    std::unordered_map<const void *, uint32_t> m_vertex_array_ids;
+    statistics_t m_statistics;
+
+    float get_depth(const shape_t &shape) const;
+
+    void build_batches();
+
+    static void set_sampler_uniforms(program_t &program);
+    instance_t make_instance(const draw_t &draw);
 };
 
 } // namespace game_engine
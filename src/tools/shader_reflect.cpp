@@ -0,0 +1,739 @@
+/**
+ * @brief Build step that parses the GLSL sources and generates a C++ header mirroring their std140 uniform blocks,
+ * integer #define constants and plain uniforms, so layout mismatches fail the build instead of rendering garbage.
+ *
+ * Usage: shader-reflect <output header> <shader source>...
+ *
+ * Only the GLSL subset the shaders use is understood: struct declarations, "layout (std140) uniform" blocks, plain
+ * uniforms, and arrays sized by an integer literal or #define. Preprocessor conditionals are not evaluated, since the
+ * feature defines of each program variant are only known at run time. Plain uniforms declared under a conditional are
+ * generated with the condition in their comment, as handles that variants without them ignore. Structs and blocks
+ * cannot follow a conditional and are rejected under one, and #define constants under one are not exported.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct member_t {
+    std::string m_type;
+    std::string m_name;
+    size_t m_array_size{};
+    std::string m_array_expression;
+
+    // Preprocessor condition the declaration is under, empty if it is declared in every variant.
+    std::string m_condition;
+};
+
+/**
+ * @brief Nesting of preprocessor conditionals, as the text of the condition each branch is taken under.
+ */
+class condition_stack_t {
+  public:
+    void handle(const std::string &source, const std::string &directive, const std::string &argument);
+    [[nodiscard]] std::string get() const;
+
+  private:
+    struct frame_t {
+        std::vector<std::string> m_skipped;
+        std::string m_condition;
+    };
+
+    std::vector<frame_t> m_frames;
+};
+
+struct struct_t {
+    std::string m_name;
+    std::vector<member_t> m_members;
+    std::string m_source;
+};
+
+struct layout_t {
+    size_t m_align{};
+    size_t m_size{};
+};
+
+class shader_layout_t {
+  public:
+    void add_define(const std::string &name, long value, const std::string &source);
+    void add_struct(struct_t s);
+    void add_block(struct_t block);
+    void add_uniform(const member_t &uniform, const std::string &source);
+
+    [[nodiscard]] const struct_t *find_struct(const std::string &name) const;
+    [[nodiscard]] long get_define(const std::string &name, const std::string &source) const;
+
+    [[nodiscard]] std::string generate(const std::vector<std::string> &sources) const;
+
+  private:
+    std::vector<std::pair<std::string, long>> m_defines;
+    std::vector<struct_t> m_structs;
+    std::vector<struct_t> m_blocks;
+    std::vector<std::pair<member_t, std::string>> m_uniforms;
+
+    layout_t member_layout(const member_t &member, const std::string &source) const;
+    layout_t struct_layout(const struct_t &s) const;
+    void collect_block_structs(const struct_t &s, std::vector<const struct_t *> &ret) const;
+    void generate_std140_struct(std::ostream &out, const struct_t &s, const std::string &cpp_name,
+                                bool is_block) const;
+    void generate_uniform(std::ostream &out, const std::string &glsl_name, const std::string &cpp_name,
+                          const std::string &type, const std::string &condition, const std::string &source) const;
+};
+
+class parser_t {
+  public:
+    parser_t(std::string source, const std::string &text, shader_layout_t &layout);
+    void parse();
+
+  private:
+    std::string m_source;
+    std::vector<std::string> m_tokens;
+    std::vector<std::string> m_conditions;
+    size_t m_position{};
+    shader_layout_t &m_layout;
+
+    [[nodiscard]] bool at_end() const;
+    [[nodiscard]] const std::string &peek() const;
+    [[nodiscard]] const std::string &peek_condition() const;
+    const std::string &next();
+    void expect(const std::string &token);
+    void skip_statement();
+
+    void parse_struct();
+    void parse_layout();
+    void parse_uniform(std::string type);
+    std::vector<member_t> parse_members();
+    void parse_array(member_t &member);
+    void tokenize(const std::string &code, const std::string &condition);
+};
+
+[[noreturn]] void fail(const std::string &source, const std::string &message) {
+    throw std::runtime_error(source + ": error: " + message);
+}
+
+size_t round_up(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+}
+
+std::string to_lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return s;
+}
+
+std::string read_file(const std::filesystem::path &path) {
+    std::ifstream file(path);
+    if (!file) {
+        fail(path.string(), "cannot open file");
+    }
+    std::stringstream ret;
+    ret << file.rdbuf();
+    return ret.str();
+}
+
+std::string strip_comments(const std::string &text) {
+    std::string ret;
+    ret.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text.compare(i, 2, "//") == 0) {
+            i = text.find('\n', i);
+            if (std::string::npos == i) {
+                break;
+            }
+            ret += '\n';
+        } else if (text.compare(i, 2, "/*") == 0) {
+            const auto end = text.find("*/", i + 2);
+            // Keep line breaks so preprocessor lines stay separate.
+            ret.append(std::count(text.begin() + static_cast<long>(i),
+                                  std::string::npos == end ? text.end() : text.begin() + static_cast<long>(end), '\n'),
+                       '\n');
+            if (std::string::npos == end) {
+                break;
+            }
+            i = end + 1;
+        } else {
+            ret += text[i];
+        }
+    }
+    return ret;
+}
+
+bool is_sampler(const std::string &type) {
+    // Integer samplers are prefixed with i or u.
+    const auto offset = type.rfind("isampler", 0) == 0 || type.rfind("usampler", 0) == 0 ? 1 : 0;
+    return type.compare(offset, 7, "sampler") == 0;
+}
+
+/**
+ * @brief Maps a GLSL type to the value type of its uniform_t handle.
+ */
+std::string handle_type(const std::string &type) {
+    static const std::map<std::string, std::string> types = {
+        {"bool", "bool"},        {"int", "int"},           {"float", "float"},       {"vec2", "glm::vec2"},
+        {"vec3", "glm::vec3"},   {"vec4", "glm::vec4"},    {"mat3", "glm::mat3"},    {"mat4", "glm::mat4"},
+    };
+    if (is_sampler(type)) {
+        return "int";
+    }
+    auto find = types.find(type);
+    return types.end() == find ? std::string() : find->second;
+}
+
+/**
+ * @brief Maps a GLSL type to its std140 alignment, size and mirroring C++ type. Booleans are 4 bytes in std140.
+ */
+bool std140_type(const std::string &type, layout_t &layout, std::string &cpp_type) {
+    static const std::map<std::string, std::pair<layout_t, std::string>> types = {
+        {"bool", {{4, 4}, "int32_t"}},      {"int", {{4, 4}, "int32_t"}},       {"uint", {{4, 4}, "uint32_t"}},
+        {"float", {{4, 4}, "float"}},       {"vec2", {{8, 8}, "glm::vec2"}},    {"vec3", {{16, 12}, "glm::vec3"}},
+        {"vec4", {{16, 16}, "glm::vec4"}},  {"mat4", {{16, 64}, "glm::mat4"}},
+    };
+    auto find = types.find(type);
+    if (types.end() == find) {
+        return false;
+    }
+    layout = find->second.first;
+    cpp_type = find->second.second;
+    return true;
+}
+
+void condition_stack_t::handle(const std::string &source, const std::string &directive, const std::string &argument) {
+    if ("#ifdef" == directive) {
+        m_frames.push_back({{}, "defined(" + argument + ")"});
+    } else if ("#ifndef" == directive) {
+        m_frames.push_back({{}, "!defined(" + argument + ")"});
+    } else if ("#if" == directive) {
+        m_frames.push_back({{}, argument});
+    } else if ("#elif" == directive || "#else" == directive) {
+        if (m_frames.empty()) {
+            fail(source, directive + " without #if");
+        }
+        auto &frame = m_frames.back();
+        frame.m_skipped.emplace_back(std::move(frame.m_condition));
+        frame.m_condition = "#elif" == directive ? argument : std::string();
+    } else if ("#endif" == directive) {
+        if (m_frames.empty()) {
+            fail(source, "#endif without #if");
+        }
+        m_frames.pop_back();
+    }
+}
+
+std::string condition_stack_t::get() const {
+    std::string ret;
+    const auto append = [&](const std::string &term) {
+        ret += (ret.empty() ? "" : " && ") + term;
+    };
+    for (const auto &frame : m_frames) {
+        for (const auto &skipped : frame.m_skipped) {
+            append("!(" + skipped + ")");
+        }
+        if (!frame.m_condition.empty()) {
+            append(frame.m_skipped.empty() ? frame.m_condition : "(" + frame.m_condition + ")");
+        }
+    }
+    return ret;
+}
+
+void shader_layout_t::add_define(const std::string &name, long value, const std::string &source) {
+    auto find = std::find_if(m_defines.begin(), m_defines.end(), [&](const auto &d) {
+        return d.first == name;
+    });
+    if (m_defines.end() == find) {
+        m_defines.emplace_back(name, value);
+    } else if (find->second != value) {
+        fail(source, name + " is " + std::to_string(value) + " but " + std::to_string(find->second) +
+                         " in another shader");
+    }
+}
+
+void shader_layout_t::add_struct(struct_t s) {
+    const auto *existing = find_struct(s.m_name);
+    if (nullptr == existing) {
+        m_structs.emplace_back(std::move(s));
+        return;
+    }
+
+    const auto same = existing->m_members.size() == s.m_members.size() &&
+                      std::equal(s.m_members.begin(), s.m_members.end(), existing->m_members.begin(),
+                                 [](const member_t &a, const member_t &b) {
+                                     return a.m_type == b.m_type && a.m_name == b.m_name &&
+                                            a.m_array_size == b.m_array_size;
+                                 });
+    if (!same) {
+        fail(s.m_source, "struct " + s.m_name + " differs from its declaration in " + existing->m_source);
+    }
+}
+
+void shader_layout_t::add_block(struct_t block) {
+    auto find = std::find_if(m_blocks.begin(), m_blocks.end(), [&](const struct_t &b) {
+        return b.m_name == block.m_name;
+    });
+    if (m_blocks.end() == find) {
+        m_blocks.emplace_back(std::move(block));
+        return;
+    }
+
+    const auto same = find->m_members.size() == block.m_members.size() &&
+                      std::equal(block.m_members.begin(), block.m_members.end(), find->m_members.begin(),
+                                 [](const member_t &a, const member_t &b) {
+                                     return a.m_type == b.m_type && a.m_name == b.m_name &&
+                                            a.m_array_size == b.m_array_size;
+                                 });
+    if (!same) {
+        fail(block.m_source, "uniform block " + block.m_name + " differs from its declaration in " + find->m_source);
+    }
+}
+
+void shader_layout_t::add_uniform(const member_t &uniform, const std::string &source) {
+    auto find = std::find_if(m_uniforms.begin(), m_uniforms.end(), [&](const auto &u) {
+        return u.first.m_name == uniform.m_name;
+    });
+    if (m_uniforms.end() == find) {
+        m_uniforms.emplace_back(uniform, source);
+    } else if (find->first.m_type != uniform.m_type) {
+        fail(source, "uniform " + uniform.m_name + " is " + uniform.m_type + " but " + find->first.m_type + " in " +
+                         find->second);
+    } else if (uniform.m_condition.empty()) {
+        find->first.m_condition.clear();
+    } else if (!find->first.m_condition.empty() && find->first.m_condition != uniform.m_condition) {
+        find->first.m_condition = "(" + find->first.m_condition + ") || (" + uniform.m_condition + ")";
+    }
+}
+
+const struct_t *shader_layout_t::find_struct(const std::string &name) const {
+    auto find = std::find_if(m_structs.begin(), m_structs.end(), [&](const struct_t &s) {
+        return s.m_name == name;
+    });
+    return m_structs.end() == find ? nullptr : &*find;
+}
+
+long shader_layout_t::get_define(const std::string &name, const std::string &source) const {
+    auto find = std::find_if(m_defines.begin(), m_defines.end(), [&](const auto &d) {
+        return d.first == name;
+    });
+    if (m_defines.end() == find) {
+        fail(source, "unknown array size " + name);
+    }
+    return find->second;
+}
+
+layout_t shader_layout_t::member_layout(const member_t &member, const std::string &source) const {
+    layout_t ret;
+    std::string cpp_type;
+    const auto *s = find_struct(member.m_type);
+    if (nullptr != s) {
+        ret = struct_layout(*s);
+    } else if (!std140_type(member.m_type, ret, cpp_type)) {
+        fail(source, "type " + member.m_type + " of " + member.m_name + " is not supported in uniform blocks");
+    }
+
+    if (0 != member.m_array_size) {
+        // Non-struct array elements are padded to 16 bytes each, which would need a wrapper type to mirror.
+        if (nullptr == s) {
+            fail(source, "array " + member.m_name + " of non-struct type is not supported in uniform blocks");
+        }
+        ret.m_size *= member.m_array_size;
+    }
+    return ret;
+}
+
+layout_t shader_layout_t::struct_layout(const struct_t &s) const {
+    layout_t ret{16, 0};
+    for (const auto &member : s.m_members) {
+        const auto layout = member_layout(member, s.m_source);
+        ret.m_align = std::max(ret.m_align, layout.m_align);
+        ret.m_size = round_up(ret.m_size, layout.m_align) + layout.m_size;
+    }
+    ret.m_size = round_up(ret.m_size, ret.m_align);
+    return ret;
+}
+
+void shader_layout_t::collect_block_structs(const struct_t &s, std::vector<const struct_t *> &ret) const {
+    for (const auto &member : s.m_members) {
+        const auto *member_struct = find_struct(member.m_type);
+        if (nullptr != member_struct && ret.end() == std::find(ret.begin(), ret.end(), member_struct)) {
+            collect_block_structs(*member_struct, ret);
+            ret.emplace_back(member_struct);
+        }
+    }
+}
+
+void shader_layout_t::generate_std140_struct(std::ostream &out, const struct_t &s, const std::string &cpp_name,
+                                             bool is_block) const {
+    out << "/**\n * @brief std140 image of " << (is_block ? "uniform block " : "struct ") << s.m_name << " in "
+        << s.m_source << ".\n */\n";
+    out << "struct " << cpp_name << " {\n";
+    if (is_block) {
+        out << "    static constexpr const char *m_block_name = \"" << s.m_name << "\";\n\n";
+    }
+
+    size_t offset = 0;
+    size_t padding_index = 0;
+    std::vector<std::pair<std::string, size_t>> offsets;
+    for (const auto &member : s.m_members) {
+        const auto layout = member_layout(member, s.m_source);
+        const auto member_offset = round_up(offset, layout.m_align);
+        if (member_offset > offset) {
+            out << "    std::array<uint8_t, " << member_offset - offset << "> m_padding" << padding_index++ << "{};\n";
+        }
+
+        std::string cpp_type = member.m_type;
+        layout_t unused;
+        std140_type(member.m_type, unused, cpp_type);
+        if (0 != member.m_array_size) {
+            cpp_type = "std::array<" + cpp_type + ", " + member.m_array_expression + ">";
+        }
+        out << "    " << cpp_type << " m_" << member.m_name << "{};\n";
+
+        offsets.emplace_back("m_" + member.m_name, member_offset);
+        offset = member_offset + layout.m_size;
+    }
+
+    const auto size = struct_layout(s).m_size;
+    if (size > offset) {
+        out << "    std::array<uint8_t, " << size - offset << "> m_padding" << padding_index << "{};\n";
+    }
+    out << "};\n\n";
+
+    for (const auto &member_offset : offsets) {
+        out << "static_assert(offsetof(" << cpp_name << ", " << member_offset.first << ") == " << member_offset.second
+            << ");\n";
+    }
+    out << "static_assert(sizeof(" << cpp_name << ") == " << size << ");\n\n";
+}
+
+void shader_layout_t::generate_uniform(std::ostream &out, const std::string &glsl_name, const std::string &cpp_name,
+                                       const std::string &type, const std::string &condition,
+                                       const std::string &source) const {
+    const auto *s = find_struct(type);
+    if (nullptr != s) {
+        for (const auto &member : s->m_members) {
+            generate_uniform(out, glsl_name + "." + member.m_name, cpp_name + "_" + member.m_name, member.m_type,
+                             condition, source);
+        }
+        return;
+    }
+
+    const auto value_type = handle_type(type);
+    if (value_type.empty()) {
+        fail(source, "type " + type + " of uniform " + glsl_name + " is not supported");
+    }
+    if (!condition.empty()) {
+        out << "// Optional, only declared when " << condition << ".\n";
+    }
+    out << "inline const uniform_t<" << value_type << "> " << cpp_name << "{\"" << glsl_name << "\"};\n";
+}
+
+std::string shader_layout_t::generate(const std::vector<std::string> &sources) const {
+    std::stringstream out;
+    out << "// Generated by shader-reflect from";
+    for (const auto &source : sources) {
+        out << " " << source;
+    }
+    out << ". Do not edit.\n";
+    out << "#pragma once\n\n";
+    out << "#include \"data_types/program.h\"\n";
+    out << "#include <array>\n#include <cstddef>\n#include <cstdint>\n#include <glm/glm.hpp>\n\n";
+    out << "// Uniforms marked optional are only declared by some program variants, depending on their feature\n";
+    out << "// defines. Setting them on a variant without them does nothing.\n\n";
+    out << "namespace game_engine::shaders {\n\n";
+
+    for (const auto &define : m_defines) {
+        out << "constexpr int " << to_lower(define.first) << " = " << define.second << ";\n";
+    }
+    out << "\n";
+
+    std::vector<const struct_t *> block_structs;
+    for (const auto &block : m_blocks) {
+        collect_block_structs(block, block_structs);
+    }
+    for (const auto *s : block_structs) {
+        generate_std140_struct(out, *s, s->m_name, false);
+    }
+    for (const auto &block : m_blocks) {
+        generate_std140_struct(out, block, block.m_name + "_t", true);
+    }
+
+    for (const auto &uniform : m_uniforms) {
+        generate_uniform(out, uniform.first.m_name, uniform.first.m_name, uniform.first.m_type,
+                         uniform.first.m_condition, uniform.second);
+    }
+
+    out << "\n} // namespace game_engine::shaders\n";
+    return out.str();
+}
+
+parser_t::parser_t(std::string source, const std::string &text, shader_layout_t &layout)
+    : m_source(std::move(source)), m_layout(layout) {
+
+    std::stringstream lines(strip_comments(text));
+    std::string line;
+    condition_stack_t conditions;
+    while (std::getline(lines, line)) {
+        std::stringstream directive(line);
+        std::string word;
+        directive >> word;
+        if (word.empty() || '#' != word[0]) {
+            tokenize(line, conditions.get());
+            continue;
+        }
+
+        std::string argument;
+        std::getline(directive >> std::ws, argument);
+        while (!argument.empty() && std::isspace(static_cast<unsigned char>(argument.back())) != 0) {
+            argument.pop_back();
+        }
+        conditions.handle(m_source, word, argument);
+
+        // Constants whose value depends on the variant have no single value to export.
+        std::stringstream define(argument);
+        std::string name;
+        std::string value;
+        if ("#define" == word && conditions.get().empty() && define >> name >> value) {
+            char *end{};
+            const auto number = std::strtol(value.c_str(), &end, 0);
+            if ('\0' == *end) {
+                m_layout.add_define(name, number, m_source);
+            }
+        }
+    }
+}
+
+void parser_t::parse() {
+    while (!at_end()) {
+        if ("struct" == peek()) {
+            parse_struct();
+        } else if ("layout" == peek()) {
+            parse_layout();
+        } else if ("uniform" == peek()) {
+            next();
+            parse_uniform(next());
+        } else {
+            skip_statement();
+        }
+    }
+}
+
+bool parser_t::at_end() const {
+    return m_position >= m_tokens.size();
+}
+
+const std::string &parser_t::peek() const {
+    static const std::string empty;
+    return at_end() ? empty : m_tokens[m_position];
+}
+
+const std::string &parser_t::peek_condition() const {
+    static const std::string empty;
+    return at_end() ? empty : m_conditions[m_position];
+}
+
+const std::string &parser_t::next() {
+    if (at_end()) {
+        fail(m_source, "unexpected end of file");
+    }
+    return m_tokens[m_position++];
+}
+
+void parser_t::expect(const std::string &token) {
+    const auto &found = next();
+    if (found != token) {
+        fail(m_source, "expected '" + token + "' but found '" + found + "'");
+    }
+}
+
+void parser_t::skip_statement() {
+    int depth = 0;
+    while (!at_end()) {
+        const auto &token = next();
+        if ("{" == token) {
+            ++depth;
+        } else if ("}" == token && --depth <= 0) {
+            return;
+        } else if (";" == token && 0 == depth) {
+            return;
+        }
+    }
+}
+
+void parser_t::parse_struct() {
+    if (!peek_condition().empty()) {
+        fail(m_source, "struct declared when " + peek_condition() + ", its C++ mirror cannot depend on the variant");
+    }
+    expect("struct");
+    struct_t s;
+    s.m_name = next();
+    s.m_source = m_source;
+    expect("{");
+    s.m_members = parse_members();
+    expect(";");
+    m_layout.add_struct(std::move(s));
+}
+
+void parser_t::parse_layout() {
+    const auto condition = peek_condition();
+    expect("layout");
+    expect("(");
+    bool std140 = false;
+    while (")" != peek()) {
+        std140 = std140 || "std140" == next();
+    }
+    expect(")");
+
+    if ("uniform" != peek()) {
+        skip_statement();
+        return;
+    }
+    next();
+
+    auto name = next();
+    if ("{" != peek()) {
+        parse_uniform(std::move(name));
+        return;
+    }
+    if (!std140) {
+        fail(m_source, "uniform block " + name + " must use the std140 layout");
+    }
+    if (!condition.empty()) {
+        fail(m_source, "uniform block " + name + " declared when " + condition +
+                           ", its C++ mirror cannot depend on the variant");
+    }
+
+    next();
+    struct_t block;
+    block.m_name = std::move(name);
+    block.m_source = m_source;
+    block.m_members = parse_members();
+    if (";" != peek()) {
+        fail(m_source, "named instances of uniform block " + block.m_name + " are not supported");
+    }
+    next();
+    m_layout.add_block(std::move(block));
+}
+
+void parser_t::parse_uniform(std::string type) {
+    while (true) {
+        member_t uniform;
+        uniform.m_type = type;
+        uniform.m_condition = peek_condition();
+        uniform.m_name = next();
+        parse_array(uniform);
+        m_layout.add_uniform(uniform, m_source);
+
+        if ("," != peek()) {
+            break;
+        }
+        next();
+    }
+    expect(";");
+}
+
+std::vector<member_t> parser_t::parse_members() {
+    static const std::vector<std::string> qualifiers = {"highp", "mediump", "lowp", "flat", "smooth"};
+
+    std::vector<member_t> ret;
+    while ("}" != peek()) {
+        auto type = next();
+        while (qualifiers.end() != std::find(qualifiers.begin(), qualifiers.end(), type)) {
+            type = next();
+        }
+
+        while (true) {
+            member_t member;
+            member.m_type = type;
+            member.m_name = next();
+            parse_array(member);
+            ret.emplace_back(std::move(member));
+
+            if ("," != peek()) {
+                break;
+            }
+            next();
+        }
+        expect(";");
+    }
+    expect("}");
+    return ret;
+}
+
+void parser_t::parse_array(member_t &member) {
+    if ("[" != peek()) {
+        return;
+    }
+    next();
+
+    const auto &size = next();
+    if (std::isdigit(static_cast<unsigned char>(size[0])) != 0) {
+        member.m_array_size = std::stoul(size, nullptr, 0);
+        member.m_array_expression = size;
+    } else {
+        member.m_array_size = static_cast<size_t>(m_layout.get_define(size, m_source));
+        member.m_array_expression = to_lower(size);
+    }
+    expect("]");
+}
+
+void parser_t::tokenize(const std::string &code, const std::string &condition) {
+    size_t i = 0;
+    while (i < code.size()) {
+        const auto c = static_cast<unsigned char>(code[i]);
+        if (std::isspace(c) != 0) {
+            ++i;
+        } else if (std::isalnum(c) != 0 || '_' == c) {
+            const auto begin = i;
+            while (i < code.size() &&
+                   (std::isalnum(static_cast<unsigned char>(code[i])) != 0 || '_' == code[i] || '.' == code[i])) {
+                ++i;
+            }
+            m_tokens.emplace_back(code.substr(begin, i - begin));
+        } else {
+            m_tokens.emplace_back(1, code[i++]);
+        }
+    }
+    m_conditions.resize(m_tokens.size(), condition);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <output header> <shader source>...\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        shader_layout_t layout;
+        std::vector<std::string> sources;
+        for (int i = 2; i < argc; ++i) {
+            const std::filesystem::path path(argv[i]);
+            sources.emplace_back(path.filename().string());
+            parser_t(path.filename().string(), read_file(path), layout).parse();
+        }
+
+        const std::filesystem::path output(argv[1]);
+        if (output.has_parent_path()) {
+            std::filesystem::create_directories(output.parent_path());
+        }
+        std::ofstream file(output);
+        file << layout.generate(sources);
+        if (!file) {
+            throw std::runtime_error(output.string() + ": error: cannot write file");
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
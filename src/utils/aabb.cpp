@@ -0,0 +1,45 @@
+#include "utils/aabb.h"
+
+namespace game_engine {
+
+bool aabb_t::is_empty() const {
+    return m_min.x > m_max.x || m_min.y > m_max.y || m_min.z > m_max.z;
+}
+
+glm::vec3 aabb_t::get_center() const {
+    return (m_min + m_max) * 0.5F;
+}
+
+glm::vec3 aabb_t::get_extents() const {
+    return (m_max - m_min) * 0.5F;
+}
+
+void aabb_t::merge(const glm::vec3 &point) {
+    m_min = glm::min(m_min, point);
+    m_max = glm::max(m_max, point);
+}
+
+void aabb_t::merge(const aabb_t &other) {
+    m_min = glm::min(m_min, other.m_min);
+    m_max = glm::max(m_max, other.m_max);
+}
+
+aabb_t aabb_t::transform(const glm::mat4 &transform) const {
+    if (is_empty()) {
+        return *this;
+    }
+
+    // The transformed extents along each axis add up the absolute contributions of every local axis.
+    const auto center = glm::vec3(transform * glm::vec4(get_center(), 1.0F));
+    const auto extents = get_extents();
+    const auto world_extents = glm::abs(glm::vec3(transform[0])) * extents.x +
+                               glm::abs(glm::vec3(transform[1])) * extents.y +
+                               glm::abs(glm::vec3(transform[2])) * extents.z;
+
+    aabb_t ret;
+    ret.m_min = center - world_extents;
+    ret.m_max = center + world_extents;
+    return ret;
+}
+
+} // namespace game_engine
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <limits>
+
+namespace game_engine {
+
+/**
+ * @brief Axis-aligned bounding box. Default constructed boxes are empty: merging anything into them yields that thing.
+ */
+struct aabb_t {
+    glm::vec3 m_min{std::numeric_limits<float>::max()};
+    glm::vec3 m_max{std::numeric_limits<float>::lowest()};
+
+    [[nodiscard]] bool is_empty() const;
+    [[nodiscard]] glm::vec3 get_center() const;
+    [[nodiscard]] glm::vec3 get_extents() const;
+
+    /**
+     * @brief Grows the box to contain a point.
+     */
+    void merge(const glm::vec3 &point);
+
+    /**
+     * @brief Grows the box to contain another box.
+     */
+    void merge(const aabb_t &other);
+
+    /**
+     * @brief Computes the box containing this box once transformed. Looser than the box of the transformed contents,
+     * but takes no more than a few multiplications.
+     * @param transform Affine transform, e.g. a model matrix.
+     */
+    [[nodiscard]] aabb_t transform(const glm::mat4 &transform) const;
+};
+
+} // namespace game_engine
@@ -0,0 +1,134 @@
+#include "utils/buffer_pool.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cppcoreguidelines-pro-bounds-pointer-arithmetic"
+
+namespace game_engine {
+
+namespace {
+
+// Every block is preceded by a header holding its size class, padded to keep the payload 16-byte aligned.
+struct alignas(16) header_t {
+    size_t m_class_index;
+    size_t m_size;
+};
+
+constexpr auto unpooled = std::numeric_limits<size_t>::max();
+
+header_t *header_of(void *block) {
+    return static_cast<header_t *>(block) - 1;
+}
+
+void *payload_of(header_t *header) {
+    return header + 1;
+}
+
+} // namespace
+
+buffer_pool_t::buffer_pool_t(size_t max_cached_bytes) : m_max_cached_bytes(max_cached_bytes) {
+}
+
+buffer_pool_t::~buffer_pool_t() {
+    trim();
+}
+
+void *buffer_pool_t::allocate(size_t size) {
+    const auto index = class_index(size);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_statistics.m_allocations;
+
+        if (unpooled != index && !m_free_blocks.at(index).empty()) {
+            auto *block = m_free_blocks.at(index).back();
+            m_free_blocks.at(index).pop_back();
+            ++m_statistics.m_reuses;
+            m_statistics.m_cached_bytes -= class_size(index);
+            return block;
+        }
+        ++m_statistics.m_system_allocations;
+    }
+
+    const auto block_size = unpooled == index ? size : class_size(index);
+    auto *header = static_cast<header_t *>(std::malloc(sizeof(header_t) + block_size));
+    if (nullptr == header) {
+        return nullptr;
+    }
+    header->m_class_index = index;
+    header->m_size = block_size;
+    return payload_of(header);
+}
+
+void *buffer_pool_t::reallocate(void *block, size_t size) {
+    if (nullptr == block) {
+        return allocate(size);
+    }
+
+    const auto *header = header_of(block);
+    if (size <= header->m_size) {
+        return block;
+    }
+
+    auto *ret = allocate(size);
+    if (nullptr != ret) {
+        std::memcpy(ret, block, header->m_size);
+        deallocate(block);
+    }
+    return ret;
+}
+
+void buffer_pool_t::deallocate(void *block) {
+    if (nullptr == block) {
+        return;
+    }
+
+    auto *header = header_of(block);
+    if (unpooled == header->m_class_index) {
+        std::free(header);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_statistics.m_cached_bytes + header->m_size > m_max_cached_bytes) {
+        lock.unlock();
+        std::free(header);
+        return;
+    }
+    m_free_blocks.at(header->m_class_index).emplace_back(block);
+    m_statistics.m_cached_bytes += header->m_size;
+}
+
+void buffer_pool_t::trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &blocks : m_free_blocks) {
+        for (auto *block : blocks) {
+            std::free(header_of(block));
+        }
+        blocks.clear();
+    }
+    m_statistics.m_cached_bytes = 0;
+}
+
+buffer_pool_t::statistics_t buffer_pool_t::get_statistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+size_t buffer_pool_t::class_index(size_t size) {
+    size_t index = 0;
+    while (index < m_class_count && class_size(index) < size) {
+        ++index;
+    }
+    return index < m_class_count ? index : unpooled;
+}
+
+size_t buffer_pool_t::class_size(size_t index) {
+    return size_t{1} << (m_min_class_shift + index);
+}
+
+} // namespace game_engine
+
+#pragma clang diagnostic pop
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Thread-safe pool of memory blocks grouped in power-of-two size classes. Released blocks are kept for reuse
+ * instead of being returned to the system, so repeatedly decoding similarly sized images stops churning the heap. The
+ * cache has its own byte budget, past which released blocks are freed, so the rounding up of blocks is not paid twice
+ * by keeping them around.
+ */
+class buffer_pool_t {
+  public:
+    struct statistics_t {
+        size_t m_allocations{};
+        size_t m_reuses{};
+        size_t m_system_allocations{};
+        size_t m_cached_bytes{};
+    };
+
+    /**
+     * @brief Creates an empty pool.
+     * @param max_cached_bytes Maximum size of the released blocks kept for reuse.
+     */
+    explicit buffer_pool_t(size_t max_cached_bytes = std::numeric_limits<size_t>::max());
+
+    /**
+     * Returns every cached block to the system. Blocks still in use must not outlive the pool.
+     */
+    ~buffer_pool_t();
+
+    buffer_pool_t(const buffer_pool_t &) = delete;
+    buffer_pool_t(buffer_pool_t &&) = delete;
+    buffer_pool_t &operator=(const buffer_pool_t &) = delete;
+    buffer_pool_t &operator=(buffer_pool_t &&) = delete;
+
+    /**
+     * @brief Gets a block of at least the requested size, reusing a cached one when possible.
+     * @param size Requested size, in bytes.
+     * @return Block aligned to 16 bytes, or nullptr if the system is out of memory.
+     */
+    void *allocate(size_t size);
+
+    /**
+     * @brief Resizes a block, keeping its contents. Stays in place if the size class still fits.
+     * @param block Block obtained from this pool, or nullptr.
+     * @param size New size, in bytes.
+     * @return Resized block, or nullptr if the system is out of memory.
+     */
+    void *reallocate(void *block, size_t size);
+
+    /**
+     * @brief Returns a block to the pool, or to the system if the cache is full.
+     * @param block Block obtained from this pool, or nullptr.
+     */
+    void deallocate(void *block);
+
+    /**
+     * @brief Returns every cached block to the system.
+     */
+    void trim();
+
+    [[nodiscard]] statistics_t get_statistics() const;
+
+  private:
+    static constexpr size_t m_min_class_shift = 12;
+    static constexpr size_t m_class_count = 16;
+
+    size_t m_max_cached_bytes;
+    std::array<std::vector<void *>, m_class_count> m_free_blocks;
+    statistics_t m_statistics;
+    mutable std::mutex m_mutex;
+
+    static size_t class_index(size_t size);
+    static size_t class_size(size_t index);
+};
+
+} // namespace game_engine
@@ -0,0 +1,363 @@
+#include "utils/bvh.h"
+
+#include <cassert>
+#include <limits>
+
+namespace game_engine {
+
+namespace {
+
+float surface_area(const aabb_t &box) {
+    if (box.is_empty()) {
+        return 0.0F;
+    }
+    const auto size = box.m_max - box.m_min;
+    return 2.0F * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool same_bounds(const aabb_t &lhs, const aabb_t &rhs) {
+    return lhs.m_min == rhs.m_min && lhs.m_max == rhs.m_max;
+}
+
+bool overlaps_sphere(const aabb_t &box, const glm::vec3 &center, float radius) {
+    const auto closest = glm::min(glm::max(center, box.m_min), box.m_max);
+    const auto offset = center - closest;
+    return glm::dot(offset, offset) <= radius * radius;
+}
+
+struct bin_t {
+    aabb_t m_bounds;
+    uint32_t m_count{};
+};
+
+} // namespace
+
+uint32_t bvh_t::insert(const aabb_t &bounds) {
+    m_structure_dirty = true;
+    if (!m_free.empty()) {
+        const auto ret = m_free.back();
+        m_free.pop_back();
+        m_objects[ret] = bounds;
+        m_alive[ret] = 1;
+        return ret;
+    }
+
+    m_objects.emplace_back(bounds);
+    m_alive.emplace_back(1);
+    return static_cast<uint32_t>(m_objects.size() - 1);
+}
+
+void bvh_t::remove(uint32_t handle) {
+    assert(handle < m_objects.size() && 0 != m_alive[handle]);
+    m_alive[handle] = 0;
+    m_objects[handle] = aabb_t();
+    m_free.emplace_back(handle);
+    m_structure_dirty = true;
+}
+
+void bvh_t::move(uint32_t handle, const aabb_t &bounds) {
+    assert(handle < m_objects.size() && 0 != m_alive[handle]);
+    if (!same_bounds(m_objects[handle], bounds)) {
+        m_objects[handle] = bounds;
+        m_bounds_dirty = true;
+    }
+}
+
+void bvh_t::update() {
+    if (m_structure_dirty) {
+        rebuild();
+        return;
+    }
+    if (!m_bounds_dirty) {
+        return;
+    }
+
+    refit();
+    if (m_statistics.m_cost > m_statistics.m_built_cost * m_rebuild_threshold) {
+        rebuild();
+    }
+}
+
+void bvh_t::rebuild() {
+    m_indices.clear();
+    m_centroids.resize(m_objects.size());
+    for (uint32_t i = 0; i < m_objects.size(); ++i) {
+        if (0 != m_alive[i]) {
+            m_indices.emplace_back(i);
+            m_centroids[i] = m_objects[i].get_center();
+        }
+    }
+
+    m_nodes.clear();
+    m_leaf_bounds.clear();
+    if (!m_indices.empty()) {
+        // A binary tree with at least one object per leaf has fewer than twice as many nodes as objects.
+        m_nodes.reserve(m_indices.size() * 2);
+
+        node_t root;
+        root.m_count = static_cast<uint32_t>(m_indices.size());
+        for (const auto index : m_indices) {
+            root.m_bounds.merge(m_objects[index]);
+        }
+        m_nodes.emplace_back(root);
+
+        std::vector<std::pair<uint32_t, size_t>> stack = {{0, 1}};
+        m_statistics.m_depth = 0;
+        while (!stack.empty()) {
+            const auto [node_index, depth] = stack.back();
+            stack.pop_back();
+            m_statistics.m_depth = std::max(m_statistics.m_depth, depth);
+
+            split(node_index);
+            const auto &node = m_nodes[node_index];
+            if (0 == node.m_count) {
+                stack.emplace_back(node.m_first, depth + 1);
+                stack.emplace_back(node.m_first + 1, depth + 1);
+            }
+        }
+
+        m_leaf_bounds.reserve(m_indices.size());
+        for (const auto index : m_indices) {
+            m_leaf_bounds.emplace_back(m_objects[index]);
+        }
+    }
+
+    m_structure_dirty = false;
+    m_bounds_dirty = false;
+    m_statistics.m_objects = m_indices.size();
+    m_statistics.m_nodes = m_nodes.size();
+    m_statistics.m_cost = compute_cost();
+    m_statistics.m_built_cost = m_statistics.m_cost;
+    ++m_statistics.m_rebuilds;
+}
+
+void bvh_t::split(uint32_t node_index) {
+    const auto first = m_nodes[node_index].m_first;
+    const auto count = m_nodes[node_index].m_count;
+    if (count <= m_max_leaf_size) {
+        return;
+    }
+
+    aabb_t centroid_bounds;
+    for (auto i = first; i < first + count; ++i) {
+        centroid_bounds.merge(m_centroids[m_indices[i]]);
+    }
+
+    // Flat axes get an infinite scale, but are never binned.
+    const auto centroid_size = centroid_bounds.m_max - centroid_bounds.m_min;
+    const auto scale = glm::vec3(static_cast<float>(m_bin_count)) / centroid_size;
+    const auto get_bin = [&](uint32_t index, int axis) {
+        const auto offset = (m_centroids[index][axis] - centroid_bounds.m_min[axis]) * scale[axis];
+        return std::min(m_bin_count - 1, static_cast<uint32_t>(offset));
+    };
+
+    // Finds the cheapest split plane among the bin boundaries of every axis.
+    int best_axis = -1;
+    uint32_t best_split = 0;
+    auto best_cost = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; ++axis) {
+        if (centroid_size[axis] <= 0.0F) {
+            continue;
+        }
+
+        std::array<bin_t, m_bin_count> bins{};
+        for (auto i = first; i < first + count; ++i) {
+            const auto index = m_indices[i];
+            const auto bin = get_bin(index, axis);
+            bins.at(bin).m_bounds.merge(m_objects[index]);
+            ++bins.at(bin).m_count;
+        }
+
+        // Sweeps from the right first, so the left sweep can price every split in one pass.
+        std::array<float, m_bin_count> right_costs{};
+        aabb_t right_bounds;
+        uint32_t right_count = 0;
+        for (auto bin = m_bin_count - 1; bin > 0; --bin) {
+            right_bounds.merge(bins.at(bin).m_bounds);
+            right_count += bins.at(bin).m_count;
+            right_costs.at(bin) = surface_area(right_bounds) * static_cast<float>(right_count);
+        }
+
+        aabb_t left_bounds;
+        uint32_t left_count = 0;
+        for (uint32_t split = 1; split < m_bin_count; ++split) {
+            left_bounds.merge(bins.at(split - 1).m_bounds);
+            left_count += bins.at(split - 1).m_count;
+            const auto cost = surface_area(left_bounds) * static_cast<float>(left_count) + right_costs.at(split);
+            if (0 != left_count && count != left_count && cost < best_cost) {
+                best_axis = axis;
+                best_split = split;
+                best_cost = cost;
+            }
+        }
+    }
+
+    auto *begin = m_indices.data() + first;
+    auto *end = begin + count;
+    auto *middle = begin + count / 2;
+    if (best_axis >= 0) {
+        middle = std::partition(begin, end, [&](uint32_t index) { return get_bin(index, best_axis) < best_split; });
+    }
+    // Otherwise every centroid is at the same spot, and any split is as good as another.
+
+    node_t left;
+    left.m_first = first;
+    left.m_count = static_cast<uint32_t>(middle - begin);
+    node_t right;
+    right.m_first = first + left.m_count;
+    right.m_count = count - left.m_count;
+    for (auto i = left.m_first; i < left.m_first + left.m_count; ++i) {
+        left.m_bounds.merge(m_objects[m_indices[i]]);
+    }
+    for (auto i = right.m_first; i < right.m_first + right.m_count; ++i) {
+        right.m_bounds.merge(m_objects[m_indices[i]]);
+    }
+
+    auto &node = m_nodes[node_index];
+    node.m_first = static_cast<uint32_t>(m_nodes.size());
+    node.m_count = 0;
+    m_nodes.emplace_back(left);
+    m_nodes.emplace_back(right);
+}
+
+void bvh_t::refit() {
+    for (size_t i = 0; i < m_indices.size(); ++i) {
+        m_leaf_bounds[i] = m_objects[m_indices[i]];
+    }
+
+    // Children always come after their parent, so a reverse walk sees them first.
+    for (auto node = m_nodes.rbegin(); node != m_nodes.rend(); ++node) {
+        node->m_bounds = aabb_t();
+        if (0 == node->m_count) {
+            node->m_bounds.merge(m_nodes[node->m_first].m_bounds);
+            node->m_bounds.merge(m_nodes[node->m_first + 1].m_bounds);
+        } else {
+            for (auto i = node->m_first; i < node->m_first + node->m_count; ++i) {
+                node->m_bounds.merge(m_leaf_bounds[i]);
+            }
+        }
+    }
+
+    m_bounds_dirty = false;
+    m_statistics.m_cost = compute_cost();
+    ++m_statistics.m_refits;
+}
+
+float bvh_t::compute_cost() const {
+    if (m_nodes.empty()) {
+        return 0.0F;
+    }
+
+    // Expected number of node visits and box tests for a random ray hitting the root.
+    const auto root_area = surface_area(m_nodes.front().m_bounds);
+    if (root_area <= 0.0F) {
+        return static_cast<float>(m_indices.size());
+    }
+
+    float ret = 0.0F;
+    for (const auto &node : m_nodes) {
+        ret += surface_area(node.m_bounds) * static_cast<float>(std::max(node.m_count, 1U));
+    }
+    return ret / root_area;
+}
+
+void bvh_t::query_frustum(const frustum_t &frustum, std::vector<uint32_t> &ret) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::vector<uint32_t> stack = {0};
+    stack.reserve(m_stack_reserve);
+    std::array<uint8_t, m_max_leaf_size> visible{};
+    while (!stack.empty()) {
+        const auto &node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!frustum.intersects(node.m_bounds)) {
+            continue;
+        }
+
+        if (0 == node.m_count) {
+            stack.push_back(node.m_first);
+            stack.push_back(node.m_first + 1);
+            continue;
+        }
+
+        // Leaf objects are stored contiguously, so they go through the batch test at once.
+        frustum.intersects(m_leaf_bounds.data() + node.m_first, node.m_count, visible.data());
+        for (uint32_t i = 0; i < node.m_count; ++i) {
+            if (0 != visible.at(i)) {
+                ret.push_back(m_indices[node.m_first + i]);
+            }
+        }
+    }
+}
+
+void bvh_t::query_sphere(const glm::vec3 &center, float radius, std::vector<uint32_t> &ret) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::vector<uint32_t> stack = {0};
+    stack.reserve(m_stack_reserve);
+    while (!stack.empty()) {
+        const auto &node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!overlaps_sphere(node.m_bounds, center, radius)) {
+            continue;
+        }
+
+        if (0 == node.m_count) {
+            stack.push_back(node.m_first);
+            stack.push_back(node.m_first + 1);
+            continue;
+        }
+
+        for (auto i = node.m_first; i < node.m_first + node.m_count; ++i) {
+            if (overlaps_sphere(m_leaf_bounds[i], center, radius)) {
+                ret.push_back(m_indices[i]);
+            }
+        }
+    }
+}
+
+void bvh_t::query_ray(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance,
+                      std::vector<uint32_t> &ret) const {
+    // Never shrinks the maximum distance, so every hit box is reported.
+    query_ray(origin, direction, max_distance, [&ret](uint32_t handle) {
+        ret.push_back(handle);
+        return -1.0F;
+    });
+}
+
+const aabb_t &bvh_t::get_bounds(uint32_t handle) const {
+    assert(handle < m_objects.size());
+    return m_objects[handle];
+}
+
+const bvh_t::statistics_t &bvh_t::get_statistics() const {
+    return m_statistics;
+}
+
+bool bvh_t::intersects_ray(const aabb_t &box, const glm::vec3 &origin, const glm::vec3 &inverse_direction,
+                           float max_distance, float &distance) {
+    // Slab test. Infinite inverse components of axis-parallel rays compare correctly, except for origins exactly on
+    // a slab boundary, which are tolerated as misses.
+    float near = 0.0F;
+    float far = max_distance;
+    for (int axis = 0; axis < 3; ++axis) {
+        auto t0 = (box.m_min[axis] - origin[axis]) * inverse_direction[axis];
+        auto t1 = (box.m_max[axis] - origin[axis]) * inverse_direction[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        near = std::max(near, t0);
+        far = std::min(far, t1);
+        if (near > far) {
+            return false;
+        }
+    }
+    distance = near;
+    return true;
+}
+
+} // namespace game_engine
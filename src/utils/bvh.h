@@ -0,0 +1,196 @@
+#pragma once
+
+#include "utils/aabb.h"
+#include "utils/frustum.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Dynamic bounding volume hierarchy over boxes, answering visibility and picking queries in logarithmic time.
+ * The tree is built top-down with a binned surface area heuristic (SAH). Moved objects only refit the node boxes,
+ * and the tree is rebuilt once refitting degraded its estimated traversal cost past a threshold, or when objects
+ * were added or removed. Changes take effect on the next update().
+ */
+class bvh_t {
+  public:
+    struct statistics_t {
+        size_t m_objects{};
+        size_t m_nodes{};
+        size_t m_depth{};
+        size_t m_rebuilds{};
+        size_t m_refits{};
+        float m_cost{};
+        float m_built_cost{};
+    };
+
+    static constexpr uint32_t m_max_leaf_size = 4;
+    static constexpr uint32_t m_bin_count = 16;
+
+    // Refitted trees are rebuilt once their SAH cost exceeds the cost right after the last build by this ratio.
+    static constexpr float m_rebuild_threshold = 1.5F;
+
+    /**
+     * @brief Adds an object.
+     * @param bounds Object box.
+     * @return Handle of the object. Handles of removed objects are reused.
+     */
+    uint32_t insert(const aabb_t &bounds);
+
+    /**
+     * @brief Removes an object.
+     * @param handle Handle returned by insert().
+     */
+    void remove(uint32_t handle);
+
+    /**
+     * @brief Changes the box of an object. Boxes identical to the current one are ignored.
+     * @param handle Handle returned by insert().
+     * @param bounds New object box.
+     */
+    void move(uint32_t handle, const aabb_t &bounds);
+
+    /**
+     * @brief Applies the changes since the last call: rebuilds the tree if objects were added or removed, refits it
+     * if objects moved, and rebuilds it if refitting degraded it too much.
+     */
+    void update();
+
+    /**
+     * @brief Rebuilds the tree from scratch, regardless of its state.
+     */
+    void rebuild();
+
+    /**
+     * @brief Collects the objects whose box is at least partially inside a frustum.
+     * @param frustum Frustum to test.
+     * @param ret Receives the handles, appended in no particular order.
+     */
+    void query_frustum(const frustum_t &frustum, std::vector<uint32_t> &ret) const;
+
+    /**
+     * @brief Collects the objects whose box overlaps a sphere.
+     * @param center Sphere center.
+     * @param radius Sphere radius.
+     * @param ret Receives the handles, appended in no particular order.
+     */
+    void query_sphere(const glm::vec3 &center, float radius, std::vector<uint32_t> &ret) const;
+
+    /**
+     * @brief Walks the objects whose box a ray hits, nearest nodes first.
+     * @param origin Ray origin.
+     * @param direction Ray direction, not necessarily normalized. Distances are in multiples of it.
+     * @param max_distance Distance past which hits are ignored.
+     * @param visitor Called with the handle of each object whose box is hit closer than the current maximum
+     * distance. Returns the distance of the hit with the object itself, or a negative value if there is none;
+     * closer hits become the new maximum distance, pruning the nodes behind them.
+     * @return Distance of the closest hit reported by the visitor, or a negative value if there is none.
+     */
+    template <class visitor_t>
+    float query_ray(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance,
+                    visitor_t &&visitor) const {
+        if (m_nodes.empty()) {
+            return -1.0F;
+        }
+
+        const auto inverse_direction = glm::vec3(1.0F) / direction;
+        float ret = -1.0F;
+        float distance = 0.0F;
+        std::vector<uint32_t> stack;
+        stack.reserve(m_stack_reserve);
+        if (intersects_ray(m_nodes.front().m_bounds, origin, inverse_direction, max_distance, distance)) {
+            stack.push_back(0);
+        }
+
+        while (!stack.empty()) {
+            const auto &node = m_nodes[stack.back()];
+            stack.pop_back();
+
+            // Nodes were pushed when hit closer than the maximum distance at the time, which may have shrunk since.
+            if (!intersects_ray(node.m_bounds, origin, inverse_direction, max_distance, distance)) {
+                continue;
+            }
+
+            if (0 == node.m_count) {
+                float left = 0.0F;
+                float right = 0.0F;
+                const auto hit_left =
+                    intersects_ray(m_nodes[node.m_first].m_bounds, origin, inverse_direction, max_distance, left);
+                const auto hit_right =
+                    intersects_ray(m_nodes[node.m_first + 1].m_bounds, origin, inverse_direction, max_distance, right);
+
+                // The nearer child goes last, so it is visited first.
+                if (hit_left && hit_right) {
+                    stack.push_back(left < right ? node.m_first + 1 : node.m_first);
+                    stack.push_back(left < right ? node.m_first : node.m_first + 1);
+                } else if (hit_left || hit_right) {
+                    stack.push_back(hit_left ? node.m_first : node.m_first + 1);
+                }
+                continue;
+            }
+
+            for (auto i = node.m_first; i < node.m_first + node.m_count; ++i) {
+                if (!intersects_ray(m_leaf_bounds[i], origin, inverse_direction, max_distance, distance)) {
+                    continue;
+                }
+                const float hit = visitor(m_indices[i]);
+                if (hit >= 0.0F && hit <= max_distance) {
+                    max_distance = hit;
+                    ret = hit;
+                }
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Collects the objects whose box a ray hits.
+     * @param origin Ray origin.
+     * @param direction Ray direction.
+     * @param max_distance Distance past which hits are ignored, in multiples of direction.
+     * @param ret Receives the handles, appended nearest nodes first.
+     */
+    void query_ray(const glm::vec3 &origin, const glm::vec3 &direction, float max_distance,
+                   std::vector<uint32_t> &ret) const;
+
+    [[nodiscard]] const aabb_t &get_bounds(uint32_t handle) const;
+    [[nodiscard]] const statistics_t &get_statistics() const;
+
+  private:
+    /**
+     * @brief Interior nodes have no objects and their children at m_first and m_first + 1, which always come after
+     * them. Leaves hold m_count objects from m_first in m_indices.
+     */
+    struct node_t {
+        aabb_t m_bounds;
+        uint32_t m_first{};
+        uint32_t m_count{};
+    };
+
+    static constexpr size_t m_stack_reserve = 64;
+
+    std::vector<aabb_t> m_objects;
+    std::vector<uint8_t> m_alive;
+    std::vector<uint32_t> m_free;
+    std::vector<glm::vec3> m_centroids;
+    std::vector<node_t> m_nodes;
+    std::vector<uint32_t> m_indices;
+    std::vector<aabb_t> m_leaf_bounds;
+    bool m_structure_dirty{};
+    bool m_bounds_dirty{};
+    statistics_t m_statistics;
+
+    void split(uint32_t node_index);
+    void refit();
+    [[nodiscard]] float compute_cost() const;
+
+    static bool intersects_ray(const aabb_t &box, const glm::vec3 &origin, const glm::vec3 &inverse_direction,
+                               float max_distance, float &distance);
+};
+
+} // namespace game_engine
@@ -0,0 +1,179 @@
+#include "utils/cluster_grid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace game_engine {
+
+cluster_grid_t::cluster_grid_t(uint32_t tiles_x, uint32_t tiles_y, uint32_t slices)
+    : m_tiles_x(tiles_x), m_tiles_y(tiles_y), m_slices(slices),
+      m_bounds(static_cast<size_t>(tiles_x) * tiles_y * slices),
+      m_clusters(static_cast<size_t>(tiles_x) * tiles_y * slices) {
+    assert(tiles_x > 0 && tiles_y > 0 && slices > 0);
+}
+
+void cluster_grid_t::update(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec4 *spheres,
+                            size_t count) {
+    if (0 != std::memcmp(&projection, &m_projection, sizeof(projection))) {
+        build_bounds(projection);
+    }
+
+    std::fill(m_clusters.begin(), m_clusters.end(), cluster_t());
+    m_assignments.clear();
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto center = glm::vec3(view * glm::vec4(glm::vec3(spheres[i]), 1.0F));
+        const auto radius = spheres[i].w;
+        const auto depth = -center.z;
+        if (radius <= 0.0F || depth + radius < m_near || depth - radius > m_far) {
+            continue;
+        }
+
+        uint32_t first_x = 0;
+        uint32_t last_x = m_tiles_x - 1;
+        uint32_t first_y = 0;
+        uint32_t last_y = m_tiles_y - 1;
+
+        // Spheres reaching the near plane may cover any tile; others are narrowed to the tiles under their box.
+        if (depth - radius > m_near) {
+            auto min_ndc = glm::vec2(std::numeric_limits<float>::max());
+            auto max_ndc = glm::vec2(std::numeric_limits<float>::lowest());
+            for (size_t corner = 0; corner < 8; ++corner) {
+                const glm::vec3 offset(0 != (corner & 1U) ? radius : -radius, 0 != (corner & 2U) ? radius : -radius,
+                                       0 != (corner & 4U) ? radius : -radius);
+                const auto clip = projection * glm::vec4(center + offset, 1.0F);
+                const glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+                min_ndc = glm::min(min_ndc, ndc);
+                max_ndc = glm::max(max_ndc, ndc);
+            }
+            if (max_ndc.x < -1.0F || min_ndc.x > 1.0F || max_ndc.y < -1.0F || min_ndc.y > 1.0F) {
+                continue;
+            }
+
+            const auto to_tile = [](float ndc, uint32_t tiles) {
+                const auto tile = std::floor((ndc * 0.5F + 0.5F) * static_cast<float>(tiles));
+                return static_cast<uint32_t>(std::clamp(tile, 0.0F, static_cast<float>(tiles - 1)));
+            };
+            first_x = to_tile(min_ndc.x, m_tiles_x);
+            last_x = to_tile(max_ndc.x, m_tiles_x);
+            first_y = to_tile(min_ndc.y, m_tiles_y);
+            last_y = to_tile(max_ndc.y, m_tiles_y);
+        }
+
+        const auto first_slice = get_slice(std::max(depth - radius, m_near));
+        const auto last_slice = get_slice(std::min(depth + radius, m_far));
+        const auto radius_squared = radius * radius;
+        for (auto slice = first_slice; slice <= last_slice; ++slice) {
+            for (auto y = first_y; y <= last_y; ++y) {
+                for (auto x = first_x; x <= last_x; ++x) {
+                    const auto index = get_cluster_index(x, y, slice);
+                    const auto &bounds = m_bounds[index];
+                    const auto delta = center - glm::clamp(center, bounds.m_min, bounds.m_max);
+                    if (glm::dot(delta, delta) <= radius_squared) {
+                        m_assignments.emplace_back(index, static_cast<uint32_t>(i));
+                        ++m_clusters[index].m_count;
+                    }
+                }
+            }
+        }
+    }
+
+    // Counting sort: offsets start at the end of each range, and walking the assignments backwards fills every range
+    // from its end, leaving the offsets at their start and the lights of each cluster in ascending order.
+    uint32_t offset = 0;
+    for (auto &cluster : m_clusters) {
+        offset += cluster.m_count;
+        cluster.m_offset = offset;
+    }
+    m_light_indices.resize(m_assignments.size());
+    for (auto it = m_assignments.rbegin(); it != m_assignments.rend(); ++it) {
+        m_light_indices[--m_clusters[it->first].m_offset] = it->second;
+    }
+}
+
+uint32_t cluster_grid_t::get_cluster_index(uint32_t x, uint32_t y, uint32_t slice) const {
+    return (slice * m_tiles_y + y) * m_tiles_x + x;
+}
+
+uint32_t cluster_grid_t::get_slice(float depth) const {
+    const auto slice = std::floor(std::log(std::max(depth, 1e-6F)) * m_depth_scale - m_depth_bias);
+    return static_cast<uint32_t>(std::clamp(slice, 0.0F, static_cast<float>(m_slices - 1)));
+}
+
+const std::vector<cluster_grid_t::cluster_t> &cluster_grid_t::get_clusters() const {
+    return m_clusters;
+}
+
+const std::vector<uint32_t> &cluster_grid_t::get_light_indices() const {
+    return m_light_indices;
+}
+
+const aabb_t &cluster_grid_t::get_bounds(uint32_t index) const {
+    return m_bounds.at(index);
+}
+
+uint32_t cluster_grid_t::get_tiles_x() const {
+    return m_tiles_x;
+}
+
+uint32_t cluster_grid_t::get_tiles_y() const {
+    return m_tiles_y;
+}
+
+uint32_t cluster_grid_t::get_slices() const {
+    return m_slices;
+}
+
+float cluster_grid_t::get_depth_scale() const {
+    return m_depth_scale;
+}
+
+float cluster_grid_t::get_depth_bias() const {
+    return m_depth_bias;
+}
+
+void cluster_grid_t::build_bounds(const glm::mat4 &projection) {
+    m_projection = projection;
+
+    // Clipping planes of an OpenGL perspective projection.
+    m_near = projection[3][2] / (projection[2][2] - 1.0F);
+    m_far = projection[3][2] / (projection[2][2] + 1.0F);
+    const auto log_ratio = std::log(m_far / m_near);
+    m_depth_scale = static_cast<float>(m_slices) / log_ratio;
+    m_depth_bias = static_cast<float>(m_slices) * std::log(m_near) / log_ratio;
+
+    // View-space points at depth 1 under each tile corner; any depth is a multiple of them.
+    const auto inverse = glm::inverse(projection);
+    std::vector<glm::vec3> corners;
+    corners.reserve(static_cast<size_t>(m_tiles_x + 1) * (m_tiles_y + 1));
+    for (uint32_t y = 0; y <= m_tiles_y; ++y) {
+        for (uint32_t x = 0; x <= m_tiles_x; ++x) {
+            const auto ndc_x = 2.0F * static_cast<float>(x) / static_cast<float>(m_tiles_x) - 1.0F;
+            const auto ndc_y = 2.0F * static_cast<float>(y) / static_cast<float>(m_tiles_y) - 1.0F;
+            const auto point = inverse * glm::vec4(ndc_x, ndc_y, 1.0F, 1.0F);
+            const auto view_point = glm::vec3(point) / point.w;
+            corners.emplace_back(view_point / -view_point.z);
+        }
+    }
+
+    for (uint32_t slice = 0; slice < m_slices; ++slice) {
+        const auto near_depth = m_near * std::pow(m_far / m_near, static_cast<float>(slice) / m_slices);
+        const auto far_depth = m_near * std::pow(m_far / m_near, static_cast<float>(slice + 1) / m_slices);
+        for (uint32_t y = 0; y < m_tiles_y; ++y) {
+            for (uint32_t x = 0; x < m_tiles_x; ++x) {
+                auto &bounds = m_bounds[get_cluster_index(x, y, slice)];
+                bounds = aabb_t();
+                for (const auto corner_index : {y * (m_tiles_x + 1) + x, y * (m_tiles_x + 1) + x + 1,
+                                                (y + 1) * (m_tiles_x + 1) + x, (y + 1) * (m_tiles_x + 1) + x + 1}) {
+                    bounds.merge(corners[corner_index] * near_depth);
+                    bounds.merge(corners[corner_index] * far_depth);
+                }
+            }
+        }
+    }
+}
+
+} // namespace game_engine
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "utils/aabb.h"
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Froxel grid over a perspective view: screen tiles split in depth slices spaced exponentially, so clusters
+ * stay roughly cubic from near to far. Lights are assigned to every cluster their bounding sphere overlaps, so
+ * fragments only evaluate the lights listed for their own cluster.
+ *
+ * Clusters are indexed by (slice * tiles_y + y) * tiles_x + x, with x and y from the bottom left of the screen and
+ * slices from the near plane. A fragment at view depth d is in slice log(d) * depth_scale - depth_bias.
+ */
+class cluster_grid_t {
+  public:
+    struct cluster_t {
+        uint32_t m_offset{};
+        uint32_t m_count{};
+    };
+
+    /**
+     * @brief Creates an empty grid.
+     * @param tiles_x Number of tiles across the screen.
+     * @param tiles_y Number of tiles down the screen.
+     * @param slices Number of depth slices.
+     */
+    cluster_grid_t(uint32_t tiles_x, uint32_t tiles_y, uint32_t slices);
+
+    /**
+     * @brief Assigns lights to clusters. Cluster bounds are only recomputed when the projection changes.
+     * @param view View matrix.
+     * @param projection Perspective projection matrix.
+     * @param spheres World-space bounding spheres of the lights, as center and radius.
+     * @param count Number of lights.
+     */
+    void update(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec4 *spheres, size_t count);
+
+    /**
+     * @brief Gets the index of a cluster.
+     * @param x Tile column.
+     * @param y Tile row.
+     * @param slice Depth slice.
+     */
+    [[nodiscard]] uint32_t get_cluster_index(uint32_t x, uint32_t y, uint32_t slice) const;
+
+    /**
+     * @brief Gets the depth slice holding a view depth.
+     * @param depth Distance from the camera plane, positive in front of it.
+     */
+    [[nodiscard]] uint32_t get_slice(float depth) const;
+
+    /**
+     * @brief Gets the range of get_light_indices() listing the lights of each cluster.
+     */
+    [[nodiscard]] const std::vector<cluster_t> &get_clusters() const;
+
+    /**
+     * @brief Gets the indices of the lights of every cluster, as passed to update(), back to back.
+     */
+    [[nodiscard]] const std::vector<uint32_t> &get_light_indices() const;
+
+    /**
+     * @brief Gets the view-space bounds of a cluster.
+     * @param index Cluster index.
+     */
+    [[nodiscard]] const aabb_t &get_bounds(uint32_t index) const;
+
+    [[nodiscard]] uint32_t get_tiles_x() const;
+    [[nodiscard]] uint32_t get_tiles_y() const;
+    [[nodiscard]] uint32_t get_slices() const;
+    [[nodiscard]] float get_depth_scale() const;
+    [[nodiscard]] float get_depth_bias() const;
+
+  private:
+    uint32_t m_tiles_x;
+    uint32_t m_tiles_y;
+    uint32_t m_slices;
+    float m_near{};
+    float m_far{};
+    float m_depth_scale{};
+    float m_depth_bias{};
+    glm::mat4 m_projection{0.0F};
+
+    std::vector<aabb_t> m_bounds;
+    std::vector<cluster_t> m_clusters;
+    std::vector<uint32_t> m_light_indices;
+    std::vector<std::pair<uint32_t, uint32_t>> m_assignments;
+
+    void build_bounds(const glm::mat4 &projection);
+};
+
+} // namespace game_engine
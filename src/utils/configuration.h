@@ -15,8 +15,11 @@ constexpr auto camera_clipping_far_max = 200.0F;
 constexpr auto camera_default_fov = 45.0F;
 constexpr auto camera_speed = 0.1F;
 constexpr auto camera_sensitivity = 0.1;
+constexpr auto uniform_block_frame = 1U;
 
-constexpr auto light_count = 10;
+constexpr size_t directional_light_max = 4;
+constexpr size_t light_max = 1024;
+constexpr auto uniform_block_lights = 0U;
 constexpr auto light_ambient = 0.2F;
 constexpr auto light_default_diffuse = 1.0F;
 constexpr auto light_directional_diffuse = 1.0F;
@@ -24,10 +27,17 @@ constexpr auto light_specular = 0.2F;
 constexpr auto light_attenuation_constant = 1.0F;
 constexpr auto light_attenuation_linear = 0.09F;
 constexpr auto light_attenuation_quadratic = 0.032F;
+// Lights are culled where their contribution falls below this, a step of an 8-bit color channel.
+constexpr auto light_attenuation_threshold = 1.0F / 256.0F;
 constexpr auto light_cutoff_begin_min = 5.0F;
 constexpr auto light_cutoff_begin = 25.0F;
 constexpr auto light_cutoff_end = 35.0F;
 constexpr auto light_cutoff_end_max = 120.0F;
+constexpr size_t light_scatter_count = 64;
+constexpr auto light_scatter_radius = 20.0F;
+constexpr auto light_scatter_height = 0.5F;
+constexpr auto light_scatter_attenuation_linear = 0.7F;
+constexpr auto light_scatter_attenuation_quadratic = 1.8F;
 constexpr std::array<glm::vec3, 3> light_positions = {glm::vec3(2.0F), glm::vec3(0.0F, 1.0F, 0.0F),
                                                       glm::vec3(-3.0F, 2.0F, -3.0F)};
 constexpr std::array<glm::vec3, 3> light_directions = {glm::vec3(-1.0F, -2.0F, -2.0F), glm::vec3(0.0F, -1.0F, 0.0F),
@@ -52,10 +62,48 @@ constexpr transform_t object_torus_transforms = {glm::vec3(-1.0F, 0.0F, -1.0F),
 constexpr transform_t object_light_transforms = {glm::vec3(0.0F, 0.0F, 0.0F), 0.0F, glm::vec3(1.0F, 1.0F, 1.0F),
                                                  glm::vec3(0.1F)};
 
+constexpr uint32_t cluster_tiles_x = 16;
+constexpr uint32_t cluster_tiles_y = 9;
+constexpr uint32_t cluster_slices = 24;
+// Objects lit by more lights fall back to the lists of the clusters they cover.
+constexpr size_t object_light_max = 16;
+
+constexpr auto occlusion_culling = true;
+constexpr size_t occlusion_buffer_width = 256;
+constexpr size_t occlusion_buffer_height = 144;
+constexpr size_t occluder_count = 8;
+constexpr size_t occluder_max_triangles = 4096;
+
+// Static shapes of a material are drawn as one group per cell of this size, so each group only reaches nearby lights.
+constexpr auto static_batch_cell_size = 8.0F;
+
+constexpr auto program_cache_directory = "cache/programs";
+// Object program variants are written here with their feature defines, since opengl-cpp compiles from files.
+constexpr auto program_source_directory = "cache/shaders";
+// Each build blocks the frame it runs in, so new programs are spread over frames.
+constexpr size_t program_builds_per_frame = 1;
+constexpr auto shader_directory = "shaders";
+// Watching the shaders costs an inotify instance and a poll per frame, which only development builds want.
+#ifdef NDEBUG
+constexpr auto shader_hot_reload = false;
+#else
+constexpr auto shader_hot_reload = true;
+#endif
+
 constexpr auto texture_layer_1 = 0;
 constexpr auto texture_layer_2 = 1;
 constexpr auto texture_diffuse = 2;
 constexpr auto texture_specular = 3;
+constexpr auto texture_unit_count = 4;
+constexpr auto texture_lights = 4;
+constexpr auto texture_clusters = 5;
+constexpr auto texture_cluster_lights = 6;
+constexpr auto texture_object_lights = 7;
+constexpr size_t texture_residency_budget = 256 * 1024 * 1024;
+constexpr auto texture_residency_min_size = 32;
+constexpr auto texture_upload_buffer_count = 4;
+constexpr size_t texture_upload_bytes_per_frame = 4 * 1024 * 1024;
+constexpr size_t image_pool_max_cached_bytes = 64 * 1024 * 1024;
 
 constexpr auto viewport_resolution_x = 1920;
 constexpr auto viewport_resolution_y = 1080;
@@ -0,0 +1,55 @@
+#include "utils/file_watcher.h"
+
+#include "utils/exception.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace game_engine {
+
+file_watcher_t::file_watcher_t(const std::filesystem::path &directory)
+    : m_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+
+    if (m_fd < 0) {
+        throw exception_t(std::string("inotify_init1() failed: ") + std::strerror(errno));
+    }
+    if (inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        const auto error = errno;
+        close(m_fd);
+        throw exception_t("cannot watch " + directory.string() + ": " + std::strerror(error));
+    }
+}
+
+file_watcher_t::~file_watcher_t() {
+    close(m_fd);
+}
+
+std::vector<std::string> file_watcher_t::poll() {
+    std::vector<std::string> ret;
+
+    // Aligned as inotify_event, as events are read in place.
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+    while (true) {
+        const auto length = read(m_fd, buffer.data(), buffer.size());
+        if (length <= 0) {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+            if (event->len > 0) {
+                std::string name(event->name);
+                if (ret.end() == std::find(ret.begin(), ret.end(), name)) {
+                    ret.emplace_back(std::move(name));
+                }
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+    return ret;
+}
+
+} // namespace game_engine
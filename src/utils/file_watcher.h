@@ -0,0 +1,42 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Watches a directory for files being written, through inotify. Both in-place writes and the write-and-rename
+ * scheme most editors use are reported.
+ */
+class file_watcher_t {
+  public:
+    /**
+     * @brief Starts watching a directory. Subdirectories are not watched.
+     * @param directory Directory to watch.
+     * @throws exception_t if inotify is unavailable or the directory cannot be watched.
+     */
+    explicit file_watcher_t(const std::filesystem::path &directory);
+
+    /**
+     * Stops watching.
+     */
+    ~file_watcher_t();
+
+    file_watcher_t(const file_watcher_t &) = delete;
+    file_watcher_t(file_watcher_t &&) = delete;
+    file_watcher_t &operator=(const file_watcher_t &) = delete;
+    file_watcher_t &operator=(file_watcher_t &&) = delete;
+
+    /**
+     * @brief Collects the files changed since the last call, without blocking.
+     * @return Names of the changed files, relative to the watched directory, each reported once.
+     */
+    std::vector<std::string> poll();
+
+  private:
+    int m_fd{-1};
+};
+
+} // namespace game_engine
@@ -0,0 +1,115 @@
+#include "utils/frustum.h"
+
+#if defined(__SSE2__)
+#define GAME_ENGINE_FRUSTUM_X86
+#include <emmintrin.h>
+#endif
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cppcoreguidelines-pro-bounds-pointer-arithmetic"
+
+namespace game_engine {
+
+namespace {
+
+#ifdef GAME_ENGINE_FRUSTUM_X86
+
+// Tests 4 boxes per iteration, transposed to one register per coordinate.
+size_t intersects_sse2(const std::array<glm::vec4, 6> &planes, const aabb_t *boxes, size_t count, uint8_t *visible) {
+    const auto sign_mask = _mm_set1_ps(-0.0F);
+    const auto half = _mm_set1_ps(0.5F);
+
+    const size_t block_boxes = 4;
+    size_t done = 0;
+    for (; done + block_boxes <= count; done += block_boxes) {
+        const auto *box = boxes + done;
+        const auto min_x = _mm_setr_ps(box[0].m_min.x, box[1].m_min.x, box[2].m_min.x, box[3].m_min.x);
+        const auto min_y = _mm_setr_ps(box[0].m_min.y, box[1].m_min.y, box[2].m_min.y, box[3].m_min.y);
+        const auto min_z = _mm_setr_ps(box[0].m_min.z, box[1].m_min.z, box[2].m_min.z, box[3].m_min.z);
+        const auto max_x = _mm_setr_ps(box[0].m_max.x, box[1].m_max.x, box[2].m_max.x, box[3].m_max.x);
+        const auto max_y = _mm_setr_ps(box[0].m_max.y, box[1].m_max.y, box[2].m_max.y, box[3].m_max.y);
+        const auto max_z = _mm_setr_ps(box[0].m_max.z, box[1].m_max.z, box[2].m_max.z, box[3].m_max.z);
+
+        const auto center_x = _mm_mul_ps(_mm_add_ps(min_x, max_x), half);
+        const auto center_y = _mm_mul_ps(_mm_add_ps(min_y, max_y), half);
+        const auto center_z = _mm_mul_ps(_mm_add_ps(min_z, max_z), half);
+        const auto extent_x = _mm_mul_ps(_mm_sub_ps(max_x, min_x), half);
+        const auto extent_y = _mm_mul_ps(_mm_sub_ps(max_y, min_y), half);
+        const auto extent_z = _mm_mul_ps(_mm_sub_ps(max_z, min_z), half);
+
+        auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const auto &plane : planes) {
+            const auto normal_x = _mm_set1_ps(plane.x);
+            const auto normal_y = _mm_set1_ps(plane.y);
+            const auto normal_z = _mm_set1_ps(plane.z);
+
+            // A box is outside a plane when even its corner furthest along the normal is behind it.
+            auto distance = _mm_add_ps(_mm_mul_ps(normal_x, center_x), _mm_set1_ps(plane.w));
+            distance = _mm_add_ps(distance, _mm_mul_ps(normal_y, center_y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(normal_z, center_z));
+            auto radius = _mm_mul_ps(_mm_andnot_ps(sign_mask, normal_x), extent_x);
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign_mask, normal_y), extent_y));
+            radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(sign_mask, normal_z), extent_z));
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        const auto mask = _mm_movemask_ps(inside);
+        for (size_t i = 0; i < block_boxes; ++i) {
+            visible[done + i] = static_cast<uint8_t>((static_cast<unsigned>(mask) >> i) & 1U);
+        }
+    }
+    return done;
+}
+
+#endif
+
+} // namespace
+
+frustum_t::frustum_t(const glm::mat4 &view_projection) {
+    // Gribb and Hartmann: each plane is the last row of the matrix plus or minus one of the others.
+    const auto row = [&view_projection](int i) {
+        return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+    };
+    m_planes = {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(3) + row(2), row(3) - row(2)};
+
+    for (auto &plane : m_planes) {
+        plane = plane / glm::length(glm::vec3(plane));
+    }
+}
+
+bool frustum_t::intersects(const aabb_t &box) const {
+    const auto center = box.get_center();
+    const auto extents = box.get_extents();
+    for (const auto &plane : m_planes) {
+        const auto normal = glm::vec3(plane);
+        if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extents) < 0.0F) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t frustum_t::intersects(const aabb_t *boxes, size_t count, uint8_t *visible) const {
+    size_t done = 0;
+#ifdef GAME_ENGINE_FRUSTUM_X86
+    done = intersects_sse2(m_planes, boxes, count, visible);
+#endif
+    for (; done < count; ++done) {
+        visible[done] = intersects(boxes[done]) ? 1 : 0;
+    }
+
+    size_t ret = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ret += visible[i];
+    }
+    return ret;
+}
+
+const std::array<glm::vec4, 6> &frustum_t::get_planes() const {
+    return m_planes;
+}
+
+} // namespace game_engine
+
+#pragma clang diagnostic pop
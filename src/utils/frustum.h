@@ -0,0 +1,48 @@
+#pragma once
+
+#include "utils/aabb.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace game_engine {
+
+/**
+ * @brief View frustum as six inward-facing planes, for culling bounding volumes on the CPU.
+ */
+class frustum_t {
+  public:
+    /**
+     * @brief Extracts the planes of the frustum of a view and projection.
+     * @param view_projection Projection matrix times view matrix.
+     */
+    explicit frustum_t(const glm::mat4 &view_projection);
+
+    /**
+     * @brief Tests whether a box is at least partially inside the frustum. Conservative: boxes close to a frustum
+     * corner may pass while being outside.
+     * @param box World-space box.
+     */
+    [[nodiscard]] bool intersects(const aabb_t &box) const;
+
+    /**
+     * @brief Tests a batch of boxes, four at a time with SSE where available.
+     * @param boxes World-space boxes.
+     * @param count Number of boxes.
+     * @param visible Receives one flag per box, non-zero if the box is at least partially inside.
+     * @return Number of visible boxes.
+     */
+    size_t intersects(const aabb_t *boxes, size_t count, uint8_t *visible) const;
+
+    /**
+     * @brief Gets the planes, as (normal, distance) with unit normals pointing inside: left, right, bottom, top,
+     * near and far.
+     */
+    [[nodiscard]] const std::array<glm::vec4, 6> &get_planes() const;
+
+  private:
+    std::array<glm::vec4, 6> m_planes{};
+};
+
+} // namespace game_engine
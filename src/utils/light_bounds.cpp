@@ -0,0 +1,58 @@
+#include "utils/light_bounds.h"
+
+#include <cmath>
+#include <limits>
+
+namespace game_engine {
+
+float attenuation_radius(float constant, float linear, float quadratic, float threshold) {
+    // Solves quadratic * d^2 + linear * d + constant = 1 / threshold for the positive root.
+    const auto target = 1.0F / threshold;
+    if (constant >= target) {
+        return 0.0F;
+    }
+    if (quadratic > 0.0F) {
+        const auto discriminant = linear * linear + 4.0F * quadratic * (target - constant);
+        return (std::sqrt(discriminant) - linear) / (2.0F * quadratic);
+    }
+    if (linear > 0.0F) {
+        return (target - constant) / linear;
+    }
+    return std::numeric_limits<float>::max();
+}
+
+glm::vec4 spot_bounding_sphere(const glm::vec3 &position, const glm::vec3 &direction, float radius,
+                               float cos_cutoff) {
+    // Narrow cones fit in a sphere through the apex and the rim, wide ones in a sphere around the rim. Cones of 90
+    // degrees or more are bounded by the full sphere of the light.
+    const auto half_sqrt = std::sqrt(0.5F);
+    if (cos_cutoff >= half_sqrt) {
+        const auto sphere_radius = radius / (2.0F * cos_cutoff);
+        return glm::vec4(position + direction * sphere_radius, sphere_radius);
+    }
+    if (cos_cutoff > 0.0F) {
+        const auto sin_cutoff = std::sqrt(1.0F - cos_cutoff * cos_cutoff);
+        return glm::vec4(position + direction * (radius * cos_cutoff), radius * sin_cutoff);
+    }
+    return glm::vec4(position, radius);
+}
+
+bool gather_lights(const aabb_t &box, const glm::vec4 *spheres, const std::vector<uint32_t> &candidates,
+                   size_t max_lights, std::vector<uint32_t> &ret) {
+    const auto first = ret.size();
+    for (const auto i : candidates) {
+        const auto center = glm::vec3(spheres[i]);
+        const auto delta = center - glm::clamp(center, box.m_min, box.m_max);
+        if (glm::dot(delta, delta) > spheres[i].w * spheres[i].w) {
+            continue;
+        }
+        if (ret.size() - first == max_lights) {
+            ret.resize(first);
+            return false;
+        }
+        ret.emplace_back(i);
+    }
+    return true;
+}
+
+} // namespace game_engine
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "utils/aabb.h"
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Computes the distance past which an attenuated light contributes less than a threshold.
+ * @param constant Constant attenuation term.
+ * @param linear Linear attenuation term.
+ * @param quadratic Quadratic attenuation term.
+ * @param threshold Attenuation below which the light is ignored, positive.
+ * @return Distance, 0 if the light never reaches the threshold, or the largest float if it never falls below it.
+ */
+float attenuation_radius(float constant, float linear, float quadratic, float threshold);
+
+/**
+ * @brief Computes a sphere bounding the region lit by a spot light, the part of a sphere inside its cone.
+ * @param position Light position.
+ * @param direction Unit direction the light points to.
+ * @param radius Light range, see attenuation_radius().
+ * @param cos_cutoff Cosine of the angle between the direction and the outer edge of the cone.
+ * @return Center and radius.
+ */
+glm::vec4 spot_bounding_sphere(const glm::vec3 &position, const glm::vec3 &direction, float radius, float cos_cutoff);
+
+/**
+ * @brief Collects the lights whose bounding spheres overlap a box, among candidates.
+ * @param box World-space box.
+ * @param spheres Bounding spheres of the lights, as center and radius.
+ * @param candidates Indices of the lights to test, in ascending order.
+ * @param max_lights Most lights to collect.
+ * @param ret Appended with the indices of the overlapping lights, in ascending order.
+ * @return false if more than max_lights overlap the box, in which case ret is left as it was.
+ */
+bool gather_lights(const aabb_t &box, const glm::vec4 *spheres, const std::vector<uint32_t> &candidates,
+                   size_t max_lights, std::vector<uint32_t> &ret);
+
+} // namespace game_engine
@@ -0,0 +1,132 @@
+#include "utils/light_store.h"
+
+#include <cassert>
+#include <utility>
+
+namespace game_engine {
+
+light_store_t::handle_t light_store_t::add(const light_t &light) {
+    const auto type = static_cast<size_t>(light.m_type);
+    if (light_type_t::deactivated == light.m_type || type >= m_type_count) {
+        return m_invalid_handle;
+    }
+
+    // Opens a slot at the end, then rotates each later range by one, moving its first light past its last one, until
+    // the free slot reaches the end of the range of the new light.
+    auto free_slot = size();
+    m_columns.m_position.emplace_back();
+    m_columns.m_direction.emplace_back();
+    m_columns.m_ambient.emplace_back();
+    m_columns.m_diffuse.emplace_back();
+    m_columns.m_specular.emplace_back();
+    m_columns.m_attenuation_constant.emplace_back();
+    m_columns.m_attenuation_linear.emplace_back();
+    m_columns.m_attenuation_quadratic.emplace_back();
+    m_columns.m_cutoff_begin.emplace_back();
+    m_columns.m_cutoff_end.emplace_back();
+    m_columns.m_shape.emplace_back();
+    m_handles.emplace_back();
+
+    ++m_first[m_type_count];
+    for (auto later = m_type_count - 1; later > type; --later) {
+        // The end of the range was already moved up by one.
+        if (m_first[later] + 1 != m_first[later + 1]) {
+            move_slot(m_first[later], free_slot);
+            free_slot = m_first[later];
+        }
+        ++m_first[later];
+    }
+
+    const auto ret = static_cast<handle_t>(m_slots.size());
+    m_slots.emplace_back(free_slot);
+    m_handles[free_slot] = ret;
+    write_slot(free_slot, light);
+    return ret;
+}
+
+light_t light_store_t::get(handle_t handle) const {
+    const auto slot = get_slot(handle);
+
+    light_t ret;
+    ret.m_type = light_type_t::deactivated;
+    for (size_t type = 0; type < m_type_count; ++type) {
+        if (slot >= m_first[type] && slot < m_first[type + 1]) {
+            ret.m_type = static_cast<light_type_t>(type);
+        }
+    }
+    ret.m_position = m_columns.m_position[slot];
+    ret.m_direction = m_columns.m_direction[slot];
+    ret.m_ambient = m_columns.m_ambient[slot];
+    ret.m_diffuse = m_columns.m_diffuse[slot];
+    ret.m_specular = m_columns.m_specular[slot];
+    ret.m_attenuation_constant = m_columns.m_attenuation_constant[slot];
+    ret.m_attenuation_linear = m_columns.m_attenuation_linear[slot];
+    ret.m_attenuation_quadratic = m_columns.m_attenuation_quadratic[slot];
+    ret.m_cutoff_begin = m_columns.m_cutoff_begin[slot];
+    ret.m_cutoff_end = m_columns.m_cutoff_end[slot];
+    ret.m_shape = m_columns.m_shape[slot];
+    return ret;
+}
+
+void light_store_t::set(handle_t handle, const light_t &light) {
+    write_slot(get_slot(handle), light);
+}
+
+size_t light_store_t::size() const {
+    return m_handles.size();
+}
+
+size_t light_store_t::get_first(light_type_t type) const {
+    return m_first.at(static_cast<size_t>(type));
+}
+
+size_t light_store_t::get_count(light_type_t type) const {
+    const auto index = static_cast<size_t>(type);
+    return m_first.at(index + 1) - m_first.at(index);
+}
+
+size_t light_store_t::get_slot(handle_t handle) const {
+    return m_slots.at(handle);
+}
+
+const std::vector<light_store_t::handle_t> &light_store_t::get_handles() const {
+    return m_handles;
+}
+
+const light_store_t::columns_t &light_store_t::get_columns() const {
+    return m_columns;
+}
+
+void light_store_t::move_slot(size_t from, size_t to) {
+    assert(from != to);
+    m_columns.m_position[to] = m_columns.m_position[from];
+    m_columns.m_direction[to] = m_columns.m_direction[from];
+    m_columns.m_ambient[to] = m_columns.m_ambient[from];
+    m_columns.m_diffuse[to] = m_columns.m_diffuse[from];
+    m_columns.m_specular[to] = m_columns.m_specular[from];
+    m_columns.m_attenuation_constant[to] = m_columns.m_attenuation_constant[from];
+    m_columns.m_attenuation_linear[to] = m_columns.m_attenuation_linear[from];
+    m_columns.m_attenuation_quadratic[to] = m_columns.m_attenuation_quadratic[from];
+    m_columns.m_cutoff_begin[to] = m_columns.m_cutoff_begin[from];
+    m_columns.m_cutoff_end[to] = m_columns.m_cutoff_end[from];
+    m_columns.m_shape[to] = std::move(m_columns.m_shape[from]);
+
+    m_handles[to] = m_handles[from];
+    m_slots[m_handles[to]] = to;
+}
+
+void light_store_t::write_slot(size_t slot, const light_t &light) {
+    m_columns.m_position[slot] = light.m_position;
+    m_columns.m_direction[slot] = light.m_direction;
+    m_columns.m_ambient[slot] = light.m_ambient;
+    m_columns.m_diffuse[slot] = light.m_diffuse;
+    m_columns.m_specular[slot] = light.m_specular;
+    m_columns.m_attenuation_constant[slot] = light.m_attenuation_constant;
+    m_columns.m_attenuation_linear[slot] = light.m_attenuation_linear;
+    m_columns.m_attenuation_quadratic[slot] = light.m_attenuation_quadratic;
+    m_columns.m_cutoff_begin[slot] = light.m_cutoff_begin;
+    m_columns.m_cutoff_end[slot] = light.m_cutoff_end;
+    m_columns.m_shape[slot] = light.m_shape;
+}
+
+} // namespace game_engine
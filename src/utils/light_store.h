@@ -0,0 +1,100 @@
+#pragma once
+
+#include "data_types/types.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Lights stored as one array per parameter, sorted by type, so each type is a contiguous range of slots that
+ * per-frame passes walk one parameter at a time without testing the type of each light. Slots move as lights are
+ * added, so lights are referred to by handles, which stay valid for the lifetime of the store.
+ */
+class light_store_t {
+  public:
+    using handle_t = uint32_t;
+    static constexpr handle_t m_invalid_handle = std::numeric_limits<handle_t>::max();
+
+    /**
+     * @brief Parameter arrays, indexed by slot.
+     */
+    struct columns_t {
+        std::vector<glm::vec3> m_position;
+        std::vector<glm::vec3> m_direction;
+        std::vector<glm::vec3> m_ambient;
+        std::vector<glm::vec3> m_diffuse;
+        std::vector<glm::vec3> m_specular;
+        std::vector<float> m_attenuation_constant;
+        std::vector<float> m_attenuation_linear;
+        std::vector<float> m_attenuation_quadratic;
+        std::vector<float> m_cutoff_begin;
+        std::vector<float> m_cutoff_end;
+        std::vector<shape_pointer_t> m_shape;
+    };
+
+    /**
+     * @brief Adds a light at the end of the range of its type. Takes one slot move per type stored after it.
+     * @param light Light parameters.
+     * @return Handle of the light, or m_invalid_handle for deactivated lights.
+     */
+    handle_t add(const light_t &light);
+
+    /**
+     * @brief Gathers the parameters of a light.
+     * @param handle Handle returned by add().
+     */
+    [[nodiscard]] light_t get(handle_t handle) const;
+
+    /**
+     * @brief Replaces the parameters of a light, except its type, which is fixed when it is added.
+     * @param handle Handle returned by add().
+     * @param light Light parameters.
+     */
+    void set(handle_t handle, const light_t &light);
+
+    [[nodiscard]] size_t size() const;
+
+    /**
+     * @brief Gets the first slot of the range of a type.
+     * @param type Light type.
+     */
+    [[nodiscard]] size_t get_first(light_type_t type) const;
+
+    /**
+     * @brief Gets the number of lights of a type.
+     * @param type Light type.
+     */
+    [[nodiscard]] size_t get_count(light_type_t type) const;
+
+    /**
+     * @brief Gets the current slot of a light.
+     * @param handle Handle returned by add().
+     */
+    [[nodiscard]] size_t get_slot(handle_t handle) const;
+
+    /**
+     * @brief Gets the handles of the lights, in slot order.
+     */
+    [[nodiscard]] const std::vector<handle_t> &get_handles() const;
+
+    [[nodiscard]] const columns_t &get_columns() const;
+
+  private:
+    static constexpr size_t m_type_count = static_cast<size_t>(light_type_t::spot) + 1;
+
+    columns_t m_columns;
+
+    // Ranges of slots per type, type i spanning [m_first[i], m_first[i + 1]).
+    std::array<size_t, m_type_count + 1> m_first{};
+    std::vector<handle_t> m_handles;
+    std::vector<size_t> m_slots;
+
+    void move_slot(size_t from, size_t to);
+    void write_slot(size_t slot, const light_t &light);
+};
+
+} // namespace game_engine
@@ -0,0 +1,121 @@
+#include "utils/object_lights.h"
+
+#include "utils/light_bounds.h"
+#include <algorithm>
+#include <cassert>
+
+namespace game_engine {
+
+namespace {
+
+aabb_t sphere_bounds(const glm::vec4 &sphere) {
+    aabb_t ret;
+    ret.m_min = glm::vec3(sphere) - sphere.w;
+    ret.m_max = glm::vec3(sphere) + sphere.w;
+    return ret;
+}
+
+} // namespace
+
+object_lights_t::object_lights_t(size_t max_lights) : m_max_lights(max_lights) {
+}
+
+void object_lights_t::update(const bvh_t &objects, size_t object_count, const glm::vec4 *spheres, size_t count) {
+    m_statistics = {};
+
+    // New objects are recomputed whatever their bounds.
+    m_bounds.resize(object_count);
+    m_dirty.resize(object_count, 1);
+    m_counts.resize(object_count);
+    m_lights.resize(object_count * m_max_lights);
+    for (uint32_t i = 0; i < object_count; ++i) {
+        const auto &bounds = objects.get_bounds(i);
+        if (bounds.m_min != m_bounds[i].m_min || bounds.m_max != m_bounds[i].m_max) {
+            m_dirty[i] = 1;
+        }
+    }
+
+    // Handles are reused once removed, so lights are only ever appended to the hierarchy, which is refilled when some
+    // vanish.
+    const auto refill = count < m_spheres.size();
+    for (size_t i = 0; i < std::max(count, m_spheres.size()); ++i) {
+        const auto existed = i < m_spheres.size();
+        const auto exists = i < count;
+        if (existed && exists && m_spheres[i] == spheres[i]) {
+            continue;
+        }
+
+        ++m_statistics.m_changed_lights;
+        if (existed) {
+            invalidate(objects, m_spheres[i]);
+        }
+        if (exists) {
+            invalidate(objects, spheres[i]);
+        }
+        if (refill) {
+            continue;
+        }
+        if (existed) {
+            m_light_bvh.move(static_cast<uint32_t>(i), sphere_bounds(spheres[i]));
+        } else {
+            [[maybe_unused]] const auto handle = m_light_bvh.insert(sphere_bounds(spheres[i]));
+            assert(handle == i);
+        }
+    }
+    if (refill) {
+        m_light_bvh = {};
+        for (size_t i = 0; i < count; ++i) {
+            m_light_bvh.insert(sphere_bounds(spheres[i]));
+        }
+    }
+    m_spheres.assign(spheres, spheres + count);
+    m_light_bvh.update();
+
+    for (uint32_t i = 0; i < object_count; ++i) {
+        if (0 == m_dirty[i]) {
+            continue;
+        }
+        const auto &bounds = objects.get_bounds(i);
+        m_bounds[i] = bounds;
+        m_dirty[i] = 0;
+        ++m_statistics.m_updated_objects;
+
+        // The hierarchy is queried with the sphere around the box, and the lights only reaching its corners dropped.
+        m_candidates.clear();
+        if (!bounds.is_empty()) {
+            m_light_bvh.query_sphere(bounds.get_center(), glm::length(bounds.get_extents()), m_candidates);
+            std::sort(m_candidates.begin(), m_candidates.end());
+        }
+        m_gathered.clear();
+        if (gather_lights(bounds, m_spheres.data(), m_candidates, m_max_lights, m_gathered)) {
+            m_counts[i] = static_cast<uint32_t>(m_gathered.size());
+            std::copy(m_gathered.begin(), m_gathered.end(), m_lights.begin() + i * m_max_lights);
+        } else {
+            m_counts[i] = static_cast<uint32_t>(m_max_lights + 1);
+        }
+    }
+}
+
+object_lights_t::list_t object_lights_t::get_lights(uint32_t object) const {
+    assert(object < m_counts.size());
+    if (m_counts[object] > m_max_lights) {
+        return {nullptr, 0, true};
+    }
+    return {m_lights.data() + object * m_max_lights, m_counts[object], false};
+}
+
+const object_lights_t::statistics_t &object_lights_t::get_statistics() const {
+    return m_statistics;
+}
+
+void object_lights_t::invalidate(const bvh_t &objects, const glm::vec4 &sphere) {
+    m_candidates.clear();
+    objects.query_sphere(glm::vec3(sphere), sphere.w, m_candidates);
+    for (const auto handle : m_candidates) {
+        if (handle < m_dirty.size()) {
+            m_dirty[handle] = 1;
+        }
+    }
+}
+
+} // namespace game_engine
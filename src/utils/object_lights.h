@@ -0,0 +1,86 @@
+#pragma once
+
+#include "utils/aabb.h"
+#include "utils/bvh.h"
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Lists the lights whose bounding spheres overlap each object, kept across frames. Only the objects that moved,
+ * and those around lights that moved, have their lists recomputed, each by querying a hierarchy over the light spheres
+ * rather than testing every light.
+ */
+class object_lights_t {
+  public:
+    struct statistics_t {
+        size_t m_changed_lights{};
+        size_t m_updated_objects{};
+    };
+
+    /**
+     * @brief Lights overlapping an object, unless there are too many of them to list.
+     */
+    struct list_t {
+        // Light indices in ascending order, m_count of them. Empty if the object overflowed.
+        const uint32_t *m_lights{};
+        size_t m_count{};
+        bool m_overflow{};
+    };
+
+    /**
+     * @brief Creates the lists, empty.
+     * @param max_lights Most lights listed per object. Objects overlapped by more lights overflow.
+     */
+    explicit object_lights_t(size_t max_lights);
+
+    /**
+     * @brief Recomputes the lists of the objects whose bounds changed, and of those overlapping the previous or the
+     * current sphere of a light that changed, appeared or vanished since the last call. Lists returned before are
+     * invalidated.
+     * @param objects Hierarchy over the objects, up to date, with handles from 0 to object_count - 1.
+     * @param object_count Number of objects.
+     * @param spheres Bounding spheres of the lights, as center and radius.
+     * @param count Number of lights.
+     */
+    void update(const bvh_t &objects, size_t object_count, const glm::vec4 *spheres, size_t count);
+
+    /**
+     * @brief Gets the lights overlapping an object as of the last update().
+     * @param object Handle of the object.
+     */
+    [[nodiscard]] list_t get_lights(uint32_t object) const;
+
+    /**
+     * @brief Gets the counters of the last update().
+     */
+    [[nodiscard]] const statistics_t &get_statistics() const;
+
+  private:
+    size_t m_max_lights;
+
+    // Spheres as of the last update, and a hierarchy over their boxes whose handles are the light indices.
+    std::vector<glm::vec4> m_spheres;
+    bvh_t m_light_bvh;
+
+    // Indexed by object: bounds its list was computed for, whether to recompute it, and its light count, which is
+    // past m_max_lights for objects that overflowed. Lists are m_max_lights apart in m_lights.
+    std::vector<aabb_t> m_bounds;
+    std::vector<uint8_t> m_dirty;
+    std::vector<uint32_t> m_counts;
+    std::vector<uint32_t> m_lights;
+
+    std::vector<uint32_t> m_candidates;
+    std::vector<uint32_t> m_gathered;
+    statistics_t m_statistics;
+
+    /**
+     * @brief Marks the objects overlapping a sphere for recomputation.
+     */
+    void invalidate(const bvh_t &objects, const glm::vec4 &sphere);
+};
+
+} // namespace game_engine
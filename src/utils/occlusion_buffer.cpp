@@ -0,0 +1,305 @@
+#include "utils/occlusion_buffer.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#define GAME_ENGINE_OCCLUSION_BUFFER_X86
+#include <emmintrin.h>
+#endif
+
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "cppcoreguidelines-pro-bounds-pointer-arithmetic"
+
+namespace game_engine {
+
+namespace {
+
+constexpr size_t block_pixels = 4;
+constexpr auto far_depth = 1.0F;
+
+/**
+ * @brief Triangle set up for rasterization. Edge functions are positive inside, and exact opposites on shared edges so
+ * that meshes have no cracks. Depth is the plane's value at the pixel center plus how much it can grow within the
+ * pixel, capped at the farthest vertex.
+ */
+struct setup_t {
+    std::array<float, 3> m_edge_a{};
+    std::array<float, 3> m_edge_b{};
+    std::array<float, 3> m_edge_c{};
+    float m_depth_a{};
+    float m_depth_b{};
+    float m_depth_c{};
+    float m_depth_max{};
+};
+
+// Evaluates the edge and depth planes in the same order as the vectorized kernel, so both round alike.
+void rasterize_row_scalar(const setup_t &setup, float *row, size_t first, size_t last, float center_y) {
+    std::array<float, 3> edge_row{};
+    for (size_t i = 0; i < 3; ++i) {
+        edge_row.at(i) = setup.m_edge_b.at(i) * center_y + setup.m_edge_c.at(i);
+    }
+    const auto depth_row = setup.m_depth_b * center_y + setup.m_depth_c;
+
+    for (auto x = first; x <= last; ++x) {
+        const auto center_x = static_cast<float>(x) + 0.5F;
+        auto inside = true;
+        for (size_t i = 0; i < 3; ++i) {
+            inside = inside && setup.m_edge_a.at(i) * center_x + edge_row.at(i) >= 0.0F;
+        }
+        if (!inside) {
+            continue;
+        }
+
+        row[x] = std::min(row[x], std::min(setup.m_depth_max, setup.m_depth_a * center_x + depth_row));
+    }
+}
+
+bool test_row_scalar(const float *row, size_t first, size_t last, float depth) {
+    for (auto x = first; x <= last; ++x) {
+        if (row[x] > depth) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef GAME_ENGINE_OCCLUSION_BUFFER_X86
+
+// Handles 4 pixels per iteration, starting from the block holding the first one. Rows are padded, so the last block
+// never reaches past the row, and pixels outside the triangle are rejected by the edge functions.
+void rasterize_row_sse2(const setup_t &setup, float *row, size_t first, size_t last, float center_y) {
+    const auto lane_offsets = _mm_setr_ps(0.5F, 1.5F, 2.5F, 3.5F);
+
+    const auto edge_a0 = _mm_set1_ps(setup.m_edge_a[0]);
+    const auto edge_a1 = _mm_set1_ps(setup.m_edge_a[1]);
+    const auto edge_a2 = _mm_set1_ps(setup.m_edge_a[2]);
+    const auto edge_row0 = _mm_set1_ps(setup.m_edge_b[0] * center_y + setup.m_edge_c[0]);
+    const auto edge_row1 = _mm_set1_ps(setup.m_edge_b[1] * center_y + setup.m_edge_c[1]);
+    const auto edge_row2 = _mm_set1_ps(setup.m_edge_b[2] * center_y + setup.m_edge_c[2]);
+    const auto depth_a = _mm_set1_ps(setup.m_depth_a);
+    const auto depth_row = _mm_set1_ps(setup.m_depth_b * center_y + setup.m_depth_c);
+    const auto depth_max = _mm_set1_ps(setup.m_depth_max);
+    const auto zero = _mm_setzero_ps();
+
+    for (auto x = first - first % block_pixels; x <= last; x += block_pixels) {
+        const auto center_x = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane_offsets);
+
+        auto inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a0, center_x), edge_row0), zero);
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a1, center_x), edge_row1), zero));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a2, center_x), edge_row2), zero));
+        if (0 == _mm_movemask_ps(inside)) {
+            continue;
+        }
+
+        const auto depth = _mm_min_ps(depth_max, _mm_add_ps(_mm_mul_ps(depth_a, center_x), depth_row));
+        const auto previous = _mm_loadu_ps(row + x);
+        const auto closer = _mm_min_ps(previous, depth);
+        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, previous)));
+    }
+}
+
+// Handles 4 pixels per iteration, masking out the lanes of the first and last blocks that are outside the range.
+bool test_row_sse2(const float *row, size_t first, size_t last, float depth) {
+    const auto depth_block = _mm_set1_ps(depth);
+    const auto all_lanes = 0xF;
+
+    for (auto x = first - first % block_pixels; x <= last; x += block_pixels) {
+        auto lanes = all_lanes;
+        if (x < first) {
+            lanes &= all_lanes << (first - x);
+        }
+        if (x + block_pixels - 1 > last) {
+            lanes &= all_lanes >> (x + block_pixels - 1 - last);
+        }
+        if (0 != (_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(row + x), depth_block)) & lanes)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
+
+void rasterize_row(const setup_t &setup, float *row, size_t first, size_t last, float center_y,
+                   [[maybe_unused]] bool vectorized) {
+#ifdef GAME_ENGINE_OCCLUSION_BUFFER_X86
+    if (vectorized) {
+        rasterize_row_sse2(setup, row, first, last, center_y);
+        return;
+    }
+#endif
+    rasterize_row_scalar(setup, row, first, last, center_y);
+}
+
+bool test_row(const float *row, size_t first, size_t last, float depth, [[maybe_unused]] bool vectorized) {
+#ifdef GAME_ENGINE_OCCLUSION_BUFFER_X86
+    if (vectorized) {
+        return test_row_sse2(row, first, last, depth);
+    }
+#endif
+    return test_row_scalar(row, first, last, depth);
+}
+
+} // namespace
+
+occlusion_buffer_t::occlusion_buffer_t(size_t width, size_t height, kernels_t kernels)
+    : m_width(width), m_height(height), m_kernels(kernels),
+      m_stride((width + block_pixels - 1) / block_pixels * block_pixels), m_depth(m_stride * height, far_depth) {
+    assert(width > 0 && height > 0);
+}
+
+void occlusion_buffer_t::clear() {
+    std::fill(m_depth.begin(), m_depth.end(), far_depth);
+    m_statistics = statistics_t();
+}
+
+void occlusion_buffer_t::rasterize(const glm::mat4 &model_view_projection, const glm::vec3 *positions,
+                                   const uint32_t *indices, size_t index_count) {
+    assert(0 == index_count % 3);
+
+    for (size_t i = 0; i < index_count; i += 3) {
+        std::array<glm::vec3, 3> v;
+        if (!project(model_view_projection, positions[indices[i]], v[0]) ||
+            !project(model_view_projection, positions[indices[i + 1]], v[1]) ||
+            !project(model_view_projection, positions[indices[i + 2]], v[2])) {
+            continue;
+        }
+
+        // Parts in front of the near plane are clipped when drawing, so they hide nothing.
+        if (v[0].z < 0.0F || v[1].z < 0.0F || v[2].z < 0.0F) {
+            continue;
+        }
+
+        auto area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+        if (0.0F == area) {
+            continue;
+        }
+        if (area < 0.0F) {
+            std::swap(v[1], v[2]);
+            area = -area;
+        }
+
+        const auto min_x = std::max(0.0F, std::floor(std::min({v[0].x, v[1].x, v[2].x})));
+        const auto max_x = std::min(static_cast<float>(m_width), std::ceil(std::max({v[0].x, v[1].x, v[2].x})));
+        const auto min_y = std::max(0.0F, std::floor(std::min({v[0].y, v[1].y, v[2].y})));
+        const auto max_y = std::min(static_cast<float>(m_height), std::ceil(std::max({v[0].y, v[1].y, v[2].y})));
+        if (min_x >= max_x || min_y >= max_y) {
+            continue;
+        }
+
+        setup_t setup;
+        for (size_t edge = 0; edge < 3; ++edge) {
+            const auto &from = v.at(edge);
+            const auto &to = v.at((edge + 1) % 3);
+            const auto a = from.y - to.y;
+            const auto b = to.x - from.x;
+            setup.m_edge_a.at(edge) = a;
+            setup.m_edge_b.at(edge) = b;
+            setup.m_edge_c.at(edge) = from.x * to.y - from.y * to.x;
+        }
+
+        // Depth is affine in screen space after the perspective divide, so it is a plane through the three vertices.
+        const auto depth_10 = v[1].z - v[0].z;
+        const auto depth_20 = v[2].z - v[0].z;
+        setup.m_depth_a = (depth_10 * (v[2].y - v[0].y) - depth_20 * (v[1].y - v[0].y)) / area;
+        setup.m_depth_b = (depth_20 * (v[1].x - v[0].x) - depth_10 * (v[2].x - v[0].x)) / area;
+        setup.m_depth_c = v[0].z - setup.m_depth_a * v[0].x - setup.m_depth_b * v[0].y +
+                          0.5F * (std::abs(setup.m_depth_a) + std::abs(setup.m_depth_b));
+        setup.m_depth_max = std::max({v[0].z, v[1].z, v[2].z});
+
+        const auto first_x = static_cast<size_t>(min_x);
+        const auto last_x = static_cast<size_t>(max_x) - 1;
+        for (auto y = static_cast<size_t>(min_y); y < static_cast<size_t>(max_y); ++y) {
+            rasterize_row(setup, m_depth.data() + y * m_stride, first_x, last_x, static_cast<float>(y) + 0.5F,
+                          kernels_t::vectorized == m_kernels);
+        }
+        ++m_statistics.m_occluder_triangles;
+    }
+}
+
+bool occlusion_buffer_t::is_visible(const aabb_t &box, const glm::mat4 &view_projection) {
+    ++m_statistics.m_tested;
+
+    auto min_x = std::numeric_limits<float>::max();
+    auto min_y = std::numeric_limits<float>::max();
+    auto min_depth = std::numeric_limits<float>::max();
+    auto max_x = std::numeric_limits<float>::lowest();
+    auto max_y = std::numeric_limits<float>::lowest();
+    for (size_t corner = 0; corner < 8; ++corner) {
+        const glm::vec3 point(0 != (corner & 1U) ? box.m_max.x : box.m_min.x,
+                              0 != (corner & 2U) ? box.m_max.y : box.m_min.y,
+                              0 != (corner & 4U) ? box.m_max.z : box.m_min.z);
+        glm::vec3 screen;
+        if (!project(view_projection, point, screen) || screen.z < 0.0F) {
+            // Boxes reaching the camera cover the whole screen in front of any occluder.
+            return true;
+        }
+        min_x = std::min(min_x, screen.x);
+        min_y = std::min(min_y, screen.y);
+        max_x = std::max(max_x, screen.x);
+        max_y = std::max(max_y, screen.y);
+        min_depth = std::min(min_depth, screen.z);
+    }
+
+    if (max_x <= 0.0F || min_x >= static_cast<float>(m_width) || max_y <= 0.0F ||
+        min_y >= static_cast<float>(m_height)) {
+        ++m_statistics.m_occluded;
+        return false;
+    }
+
+    // Occluders claim whole pixels whose center they cover, so the rectangle is grown by a pixel to reach past them.
+    const auto first_x = std::max(0.0F, std::floor(min_x) - 1.0F);
+    const auto end_x = std::min(static_cast<float>(m_width), std::ceil(max_x) + 1.0F);
+    const auto first_y = std::max(0.0F, std::floor(min_y) - 1.0F);
+    const auto end_y = std::min(static_cast<float>(m_height), std::ceil(max_y) + 1.0F);
+
+    for (auto y = static_cast<size_t>(first_y); y < static_cast<size_t>(end_y); ++y) {
+        if (test_row(m_depth.data() + y * m_stride, static_cast<size_t>(first_x), static_cast<size_t>(end_x) - 1,
+                     min_depth, kernels_t::vectorized == m_kernels)) {
+            return true;
+        }
+    }
+    ++m_statistics.m_occluded;
+    return false;
+}
+
+size_t occlusion_buffer_t::get_width() const {
+    return m_width;
+}
+
+size_t occlusion_buffer_t::get_height() const {
+    return m_height;
+}
+
+float occlusion_buffer_t::get_depth(size_t x, size_t y) const {
+    assert(x < m_width && y < m_height);
+    return m_depth[y * m_stride + x];
+}
+
+const occlusion_buffer_t::statistics_t &occlusion_buffer_t::get_statistics() const {
+    return m_statistics;
+}
+
+bool occlusion_buffer_t::project(const glm::mat4 &transform, const glm::vec3 &point, glm::vec3 &ret) const {
+    // Below this clip-space w the point is considered on or behind the camera plane.
+    constexpr auto min_w = 1e-5F;
+
+    const auto clip = transform * glm::vec4(point, 1.0F);
+    if (clip.w < min_w) {
+        return false;
+    }
+
+    const auto inverse_w = 1.0F / clip.w;
+    ret.x = (clip.x * inverse_w * 0.5F + 0.5F) * static_cast<float>(m_width);
+    ret.y = (clip.y * inverse_w * 0.5F + 0.5F) * static_cast<float>(m_height);
+    ret.z = clip.z * inverse_w * 0.5F + 0.5F;
+    return true;
+}
+
+} // namespace game_engine
+
+#pragma clang diagnostic pop
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "utils/aabb.h"
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Low-resolution depth buffer rasterized on the CPU, for culling objects hidden behind large occluders before
+ * they are submitted. Occluders write the pixels whose center they cover, at the farthest depth they reach within
+ * them, and boxes are tested against every pixel around their screen rectangle, so only hidden boxes are dropped up to
+ * sub-pixel slivers along occluder silhouettes.
+ */
+class occlusion_buffer_t {
+  public:
+    struct statistics_t {
+        size_t m_occluder_triangles{};
+        size_t m_tested{};
+        size_t m_occluded{};
+    };
+
+    /**
+     * @brief Row kernels rasterizing and testing pixels. Both give the same results.
+     */
+    enum class kernels_t {
+        scalar,
+
+        // Four pixels at a time with SSE2, or scalar where unavailable.
+        vectorized
+    };
+
+    /**
+     * @brief Creates the buffer, cleared to the far plane.
+     * @param width Width in pixels.
+     * @param height Height in pixels.
+     * @param kernels Row kernels to run.
+     */
+    occlusion_buffer_t(size_t width, size_t height, kernels_t kernels = kernels_t::vectorized);
+
+    /**
+     * @brief Resets every pixel to the far plane, and the statistics.
+     */
+    void clear();
+
+    /**
+     * @brief Rasterizes occluder triangles of either winding. Triangles reaching behind the near plane are skipped,
+     * which only loses occlusion.
+     * @param model_view_projection Transform from the vertices' space to clip space.
+     * @param positions Vertex positions.
+     * @param indices Three vertex indices per triangle.
+     * @param index_count Number of indices.
+     */
+    void rasterize(const glm::mat4 &model_view_projection, const glm::vec3 *positions, const uint32_t *indices,
+                   size_t index_count);
+
+    /**
+     * @brief Tests whether any part of a box may be visible past the occluders rasterized so far.
+     * @param box World-space box.
+     * @param view_projection Transform from world space to clip space.
+     * @return false only if the box is entirely hidden or off-screen.
+     */
+    [[nodiscard]] bool is_visible(const aabb_t &box, const glm::mat4 &view_projection);
+
+    [[nodiscard]] size_t get_width() const;
+    [[nodiscard]] size_t get_height() const;
+
+    /**
+     * @brief Gets the depth of a pixel, in [0, 1] from the near to the far plane.
+     * @param x Column, from the left.
+     * @param y Row, from the bottom.
+     */
+    [[nodiscard]] float get_depth(size_t x, size_t y) const;
+
+    [[nodiscard]] const statistics_t &get_statistics() const;
+
+  private:
+    size_t m_width;
+    size_t m_height;
+    kernels_t m_kernels;
+
+    // Rows are padded to a multiple of four pixels, so four-wide blocks never need a scalar tail.
+    size_t m_stride;
+    std::vector<float> m_depth;
+    statistics_t m_statistics;
+
+    /**
+     * @brief Projects a point to screen space, with x and y in pixels and z in [0, 1].
+     * @return false if the point is behind the near plane.
+     */
+    bool project(const glm::mat4 &transform, const glm::vec3 &point, glm::vec3 &ret) const;
+};
+
+} // namespace game_engine
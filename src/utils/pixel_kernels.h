@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+namespace game_engine {
+
+/**
+ * @brief Expands tightly packed RGB pixels into RGBA with an opaque alpha channel.
+ * @param src Source RGB pixels, pixel_count * 3 bytes.
+ * @param dst Destination RGBA pixels, pixel_count * 4 bytes. Must not overlap src.
+ * @param pixel_count Number of pixels.
+ */
+void expand_rgb_to_rgba(const unsigned char *src, unsigned char *dst, size_t pixel_count);
+
+/**
+ * @brief Flips an image upside down, in place.
+ * @param data Image rows, tightly packed.
+ * @param row_bytes Size of a row.
+ * @param rows Number of rows.
+ */
+void flip_vertically(unsigned char *data, size_t row_bytes, size_t rows);
+
+/**
+ * @brief Multiplies the color channels of RGBA pixels by their alpha, in place.
+ * @param data RGBA pixels.
+ * @param pixel_count Number of pixels.
+ */
+void premultiply_alpha(unsigned char *data, size_t pixel_count);
+
+/**
+ * @brief Converts the color channels of RGBA pixels from sRGB to linear encoding, in place. Alpha is left untouched.
+ * @param data RGBA pixels.
+ * @param pixel_count Number of pixels.
+ */
+void srgb_to_linear(unsigned char *data, size_t pixel_count);
+
+} // namespace game_engine
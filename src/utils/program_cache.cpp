@@ -0,0 +1,148 @@
+#include "utils/program_cache.h"
+
+#include <array>
+#include <boost/log/trivial.hpp>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+namespace game_engine {
+
+namespace {
+
+constexpr std::array<char, 4> file_magic = {'G', 'E', 'P', 'B'};
+constexpr uint32_t file_version = 1;
+
+struct file_header_t {
+    std::array<char, 4> m_magic{};
+    uint32_t m_version{};
+    uint64_t m_key{};
+    uint32_t m_format{};
+    uint32_t m_size{};
+};
+
+constexpr uint64_t fnv_offset_basis = 0xcbf29ce484222325ULL;
+constexpr uint64_t fnv_prime = 0x100000001b3ULL;
+
+uint64_t fnv1a(const std::string &data, uint64_t hash) {
+    for (const auto c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= fnv_prime;
+    }
+    return hash;
+}
+
+} // namespace
+
+program_cache_t::program_cache_t(std::filesystem::path directory) : m_directory(std::move(directory)) {
+}
+
+uint64_t program_cache_t::make_key(const std::vector<std::string> &sources, const std::string &driver) {
+    // The size of each part is hashed as well, so moving text from one source to the next changes the key.
+    auto hash = fnv_offset_basis;
+    for (const auto &source : sources) {
+        hash = fnv1a(std::to_string(source.size()), hash);
+        hash = fnv1a(source, hash);
+    }
+    hash = fnv1a(std::to_string(driver.size()), hash);
+    return fnv1a(driver, hash);
+}
+
+std::optional<program_binary_t> program_cache_t::load(uint64_t key) {
+    std::ifstream file(get_path(key), std::ios::binary);
+    if (!file) {
+        ++m_statistics.m_misses;
+        return std::nullopt;
+    }
+
+    file_header_t header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || file_magic != header.m_magic || file_version != header.m_version || key != header.m_key) {
+        BOOST_LOG_TRIVIAL(warning) << "Ignoring invalid program cache file " << get_path(key);
+        ++m_statistics.m_misses;
+        return std::nullopt;
+    }
+
+    // The size is checked against the file before allocating, so a corrupt header cannot ask for gigabytes.
+    std::error_code error;
+    const auto file_size = std::filesystem::file_size(get_path(key), error);
+    if (error || file_size != sizeof(header) + header.m_size) {
+        BOOST_LOG_TRIVIAL(warning) << "Ignoring truncated program cache file " << get_path(key);
+        ++m_statistics.m_misses;
+        return std::nullopt;
+    }
+
+    program_binary_t ret;
+    ret.m_format = header.m_format;
+    ret.m_data.resize(header.m_size);
+    file.read(reinterpret_cast<char *>(ret.m_data.data()), static_cast<std::streamsize>(ret.m_data.size()));
+    if (!file) {
+        BOOST_LOG_TRIVIAL(warning) << "Ignoring truncated program cache file " << get_path(key);
+        ++m_statistics.m_misses;
+        return std::nullopt;
+    }
+
+    ++m_statistics.m_hits;
+    return ret;
+}
+
+void program_cache_t::store(uint64_t key, const program_binary_t &binary) {
+    if (binary.m_data.empty()) {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        BOOST_LOG_TRIVIAL(warning) << "Cannot create program cache " << m_directory << ": " << error.message();
+        return;
+    }
+
+    file_header_t header;
+    header.m_magic = file_magic;
+    header.m_version = file_version;
+    header.m_key = key;
+    header.m_format = binary.m_format;
+    header.m_size = static_cast<uint32_t>(binary.m_data.size());
+
+    // Written aside and renamed, so a crash never leaves a partial file under the final name.
+    const auto path = get_path(key);
+    auto temporary_path = path;
+    temporary_path += ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(binary.m_data.data()),
+                   static_cast<std::streamsize>(binary.m_data.size()));
+        file.close();
+        if (!file) {
+            BOOST_LOG_TRIVIAL(warning) << "Cannot write program cache file " << temporary_path;
+            std::filesystem::remove(temporary_path, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        BOOST_LOG_TRIVIAL(warning) << "Cannot write program cache file " << path << ": " << error.message();
+        std::filesystem::remove(temporary_path, error);
+    }
+}
+
+void program_cache_t::reject(uint64_t key) {
+    ++m_statistics.m_rejections;
+    std::error_code error;
+    std::filesystem::remove(get_path(key), error);
+}
+
+const program_cache_t::statistics_t &program_cache_t::get_statistics() const {
+    return m_statistics;
+}
+
+std::filesystem::path program_cache_t::get_path(uint64_t key) const {
+    std::stringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return m_directory / name.str();
+}
+
+} // namespace game_engine
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Linked program as returned by glGetProgramBinary.
+ */
+struct program_binary_t {
+    uint32_t m_format{};
+    std::vector<uint8_t> m_data;
+};
+
+/**
+ * @brief On-disk cache of program binaries, one file per key. Binaries are driver specific, so keys must cover
+ * everything that changes the result of a build, see make_key().
+ */
+class program_cache_t {
+  public:
+    struct statistics_t {
+        size_t m_hits{};
+        size_t m_misses{};
+        size_t m_rejections{};
+    };
+
+    /**
+     * @brief Creates the cache.
+     * @param directory Directory holding the cached binaries, created on the first store.
+     */
+    explicit program_cache_t(std::filesystem::path directory);
+
+    /**
+     * @brief Builds a cache key from everything a program binary depends on.
+     * @param sources Shader sources, with their defines already injected.
+     * @param driver Identification of the driver the binary is built by, e.g. renderer and version strings.
+     * @return 64-bit FNV-1a hash.
+     */
+    static uint64_t make_key(const std::vector<std::string> &sources, const std::string &driver);
+
+    /**
+     * @brief Loads a cached binary. Counts a hit or a miss.
+     * @param key Cache key.
+     * @return Binary, or nothing if not cached or the file is damaged.
+     */
+    std::optional<program_binary_t> load(uint64_t key);
+
+    /**
+     * @brief Writes a binary to the cache. Failures are logged and otherwise ignored.
+     * @param key Cache key.
+     * @param binary Binary to store, ignored if empty.
+     */
+    void store(uint64_t key, const program_binary_t &binary);
+
+    /**
+     * @brief Drops a binary the driver refused to load, so it is rebuilt from source and stored again.
+     * @param key Cache key.
+     */
+    void reject(uint64_t key);
+
+    [[nodiscard]] const statistics_t &get_statistics() const;
+
+  private:
+    std::filesystem::path m_directory;
+    statistics_t m_statistics;
+
+    [[nodiscard]] std::filesystem::path get_path(uint64_t key) const;
+};
+
+} // namespace game_engine
@@ -0,0 +1,42 @@
+#include "utils/ray.h"
+
+#include <cmath>
+
+namespace game_engine {
+
+ray_t ray_t::transform(const glm::mat4 &transform) const {
+    ray_t ret;
+    ret.m_origin = glm::vec3(transform * glm::vec4(m_origin, 1.0F));
+    ret.m_direction = glm::vec3(transform * glm::vec4(m_direction, 0.0F));
+    return ret;
+}
+
+float intersect_triangle(const ray_t &ray, const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2) {
+    // Below this determinant the ray is considered parallel to the triangle plane.
+    constexpr auto epsilon = 1e-8F;
+
+    const auto edge1 = v1 - v0;
+    const auto edge2 = v2 - v0;
+    const auto p = glm::cross(ray.m_direction, edge2);
+    const auto determinant = glm::dot(edge1, p);
+    if (std::abs(determinant) < epsilon) {
+        return -1.0F;
+    }
+
+    const auto inverse_determinant = 1.0F / determinant;
+    const auto s = ray.m_origin - v0;
+    const auto u = glm::dot(s, p) * inverse_determinant;
+    if (u < 0.0F || u > 1.0F) {
+        return -1.0F;
+    }
+
+    const auto q = glm::cross(s, edge1);
+    const auto v = glm::dot(ray.m_direction, q) * inverse_determinant;
+    if (v < 0.0F || u + v > 1.0F) {
+        return -1.0F;
+    }
+
+    return glm::dot(edge2, q) * inverse_determinant;
+}
+
+} // namespace game_engine
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace game_engine {
+
+/**
+ * @brief Ray, as an origin and a direction. Distances along it are in multiples of the direction, which is not
+ * necessarily normalized, so they are preserved by affine transforms.
+ */
+struct ray_t {
+    glm::vec3 m_origin{};
+    glm::vec3 m_direction{};
+
+    /**
+     * @brief Transforms the ray, e.g. from world to object space.
+     * @param transform Affine transform.
+     */
+    [[nodiscard]] ray_t transform(const glm::mat4 &transform) const;
+};
+
+/**
+ * @brief Intersects a ray with a triangle, from either side (Möller and Trumbore).
+ * @param ray Ray.
+ * @param v0 First triangle vertex.
+ * @param v1 Second triangle vertex.
+ * @param v2 Third triangle vertex.
+ * @return Distance of the hit along the ray, or a negative value if there is none.
+ */
+float intersect_triangle(const ray_t &ray, const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2);
+
+} // namespace game_engine
@@ -0,0 +1,78 @@
+#include "utils/render_queue.h"
+
+#include <algorithm>
+#include <array>
+
+namespace game_engine {
+
+namespace {
+
+constexpr unsigned radix_bits = 8;
+constexpr size_t radix_size = 1U << radix_bits;
+constexpr unsigned radix_passes = 64 / radix_bits;
+
+static_assert(render_queue_t::m_program_bits + render_queue_t::m_material_bits +
+                      render_queue_t::m_vertex_array_bits + render_queue_t::m_depth_bits ==
+                  64,
+              "render queue key fields must fill the key");
+
+uint64_t clamp_field(uint32_t value, unsigned bits) {
+    const auto max = (uint64_t{1} << bits) - 1;
+    return std::min(static_cast<uint64_t>(value), max);
+}
+
+} // namespace
+
+uint64_t render_queue_t::make_key(uint32_t program, uint32_t material, uint32_t vertex_array, float depth) {
+    const auto depth_max = (uint64_t{1} << m_depth_bits) - 1;
+    const auto quantized_depth = static_cast<uint64_t>(std::clamp(depth, 0.0F, 1.0F) * static_cast<float>(depth_max));
+
+    auto ret = clamp_field(program, m_program_bits);
+    ret = ret << m_material_bits | clamp_field(material, m_material_bits);
+    ret = ret << m_vertex_array_bits | clamp_field(vertex_array, m_vertex_array_bits);
+    return ret << m_depth_bits | std::min(quantized_depth, depth_max);
+}
+
+void render_queue_t::push(uint64_t key, uint32_t index) {
+    m_items.push_back({key, index});
+}
+
+void render_queue_t::sort() {
+    // One histogram pass serves every byte.
+    std::array<std::array<size_t, radix_size>, radix_passes> histograms{};
+    for (const auto &item : m_items) {
+        for (unsigned pass = 0; pass < radix_passes; ++pass) {
+            ++histograms.at(pass).at((item.m_key >> (pass * radix_bits)) & (radix_size - 1));
+        }
+    }
+
+    m_scratch.resize(m_items.size());
+    for (unsigned pass = 0; pass < radix_passes; ++pass) {
+        auto &histogram = histograms.at(pass);
+        const auto digit = m_items.empty() ? 0 : (m_items.front().m_key >> (pass * radix_bits)) & (radix_size - 1);
+        if (histogram.at(digit) == m_items.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto &count : histogram) {
+            const auto bucket_size = count;
+            count = offset;
+            offset += bucket_size;
+        }
+        for (const auto &item : m_items) {
+            m_scratch[histogram.at((item.m_key >> (pass * radix_bits)) & (radix_size - 1))++] = item;
+        }
+        m_items.swap(m_scratch);
+    }
+}
+
+void render_queue_t::clear() {
+    m_items.clear();
+}
+
+const std::vector<render_queue_t::item_t> &render_queue_t::get_items() const {
+    return m_items;
+}
+
+} // namespace game_engine
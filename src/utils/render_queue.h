@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Queue of draws ordered by a 64-bit sort key, so draws sharing state end up next to each other. From the most
+ * to the least significant bits, the key holds the program, the material, the vertex array and the depth: program
+ * switches become the rarest change, and draws sharing all state run front to back.
+ */
+class render_queue_t {
+  public:
+    static constexpr unsigned m_program_bits = 12;
+    static constexpr unsigned m_material_bits = 16;
+    static constexpr unsigned m_vertex_array_bits = 16;
+    static constexpr unsigned m_depth_bits = 20;
+
+    struct item_t {
+        uint64_t m_key;
+        uint32_t m_index;
+    };
+
+    /**
+     * @brief Packs the state of a draw in a sort key. Identifiers past the capacity of their field are clamped, which
+     * only weakens the grouping.
+     * @param program Program identifier.
+     * @param material Material identifier.
+     * @param vertex_array Vertex array identifier.
+     * @param depth Normalized depth, clamped to [0, 1].
+     * @return Sort key.
+     */
+    static uint64_t make_key(uint32_t program, uint32_t material, uint32_t vertex_array, float depth);
+
+    /**
+     * @brief Queues a draw.
+     * @param key Sort key, from make_key().
+     * @param index Caller-defined index of the draw, returned along with the key once sorted.
+     */
+    void push(uint64_t key, uint32_t index);
+
+    /**
+     * @brief Sorts the queued draws by key with a stable LSD radix sort, one byte per pass. Passes over bytes shared
+     * by every key are skipped, so unused high identifier bits cost nothing.
+     */
+    void sort();
+
+    void clear();
+    [[nodiscard]] const std::vector<item_t> &get_items() const;
+
+  private:
+    std::vector<item_t> m_items;
+    std::vector<item_t> m_scratch;
+};
+
+} // namespace game_engine
@@ -0,0 +1,70 @@
+#include "utils/static_groups.h"
+
+#include <map>
+#include <tuple>
+
+namespace game_engine {
+
+bool is_same_material(const material_t &lhs, const material_t &rhs) {
+    return lhs.m_ambient == rhs.m_ambient && lhs.m_diffuse == rhs.m_diffuse && lhs.m_specular == rhs.m_specular &&
+           lhs.m_shininess == rhs.m_shininess && lhs.m_texture1 == rhs.m_texture1 &&
+           lhs.m_texture2 == rhs.m_texture2 && lhs.m_texture2_layer == rhs.m_texture2_layer &&
+           lhs.m_texture_mix == rhs.m_texture_mix;
+}
+
+static_groups_t::static_groups_t(float cell_size) : m_cell_size(cell_size) {
+}
+
+void static_groups_t::build(const std::vector<member_t> &members) {
+    m_groups.clear();
+    m_member_groups.clear();
+    m_vertex_count = 0;
+
+    // Distinct materials are few, so a linear search finds them. Groups are keyed by material and cell.
+    std::vector<const material_t *> materials;
+    std::map<std::tuple<size_t, int, int, int>, size_t> keys;
+    for (size_t i = 0; i < members.size(); ++i) {
+        const auto &member = members[i];
+        size_t material = 0;
+        while (material < materials.size() && !is_same_material(*materials[material], member.m_material)) {
+            ++material;
+        }
+        if (material == materials.size()) {
+            materials.emplace_back(&member.m_material);
+        }
+
+        const auto cell = glm::floor(member.m_bounds.get_center() / m_cell_size);
+        const auto key = std::make_tuple(material, static_cast<int>(cell.x), static_cast<int>(cell.y),
+                                         static_cast<int>(cell.z));
+        const auto index = keys.emplace(key, m_groups.size()).first->second;
+        if (index == m_groups.size()) {
+            m_groups.emplace_back().m_material = member.m_material;
+        }
+        auto &group = m_groups[index];
+        group.m_bounds.merge(member.m_bounds);
+        group.m_members.emplace_back(i);
+        m_member_groups.emplace_back(index);
+    }
+
+    for (auto &group : m_groups) {
+        group.m_first_vertex = m_vertex_count;
+        for (const auto member : group.m_members) {
+            group.m_vertex_count += members[member].m_vertex_count;
+        }
+        m_vertex_count += group.m_vertex_count;
+    }
+}
+
+size_t static_groups_t::get_group(size_t member) const {
+    return m_member_groups.at(member);
+}
+
+const std::vector<static_groups_t::group_t> &static_groups_t::get_groups() const {
+    return m_groups;
+}
+
+size_t static_groups_t::get_vertex_count() const {
+    return m_vertex_count;
+}
+
+} // namespace game_engine
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "data_types/types.h"
+#include "utils/aabb.h"
+#include <cstddef>
+#include <vector>
+
+namespace game_engine {
+
+/**
+ * @brief Tests whether two materials draw the same, textures and per-instance parameters alike.
+ */
+bool is_same_material(const material_t &lhs, const material_t &rhs);
+
+/**
+ * @brief Sorts the shapes merged into the static batch into the groups drawing them: shapes sharing a material and the
+ * cell of a world-space grid their center falls in. Splitting materials by cell keeps the bounds of each group close
+ * to its shapes, so it is only reached by the lights around them. Each group covers a range of the merged vertices,
+ * where the vertices of its shapes follow each other in the order the shapes were given.
+ */
+class static_groups_t {
+  public:
+    struct member_t {
+        material_t m_material;
+        aabb_t m_bounds;
+        size_t m_vertex_count{};
+    };
+
+    struct group_t {
+        material_t m_material;
+        aabb_t m_bounds;
+        std::vector<size_t> m_members;
+        size_t m_first_vertex{};
+        size_t m_vertex_count{};
+    };
+
+    /**
+     * @brief Creates the groups, empty.
+     * @param cell_size Edge length of the grid cells.
+     */
+    explicit static_groups_t(float cell_size);
+
+    /**
+     * @brief Groups shapes, replacing the previous groups.
+     * @param members Material, world-space bounds and vertex count of each shape.
+     */
+    void build(const std::vector<member_t> &members);
+
+    /**
+     * @brief Gets the group a shape was put in.
+     * @param member Index of the shape in the members passed to build().
+     * @return Index in get_groups().
+     */
+    [[nodiscard]] size_t get_group(size_t member) const;
+
+    /**
+     * @brief Gets the groups, in the order their first shape was given. Their ranges follow each other in that order.
+     */
+    [[nodiscard]] const std::vector<group_t> &get_groups() const;
+
+    [[nodiscard]] size_t get_vertex_count() const;
+
+  private:
+    float m_cell_size;
+    std::vector<group_t> m_groups;
+    std::vector<size_t> m_member_groups;
+    size_t m_vertex_count{};
+};
+
+} // namespace game_engine
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Fixture giving each test an empty directory of its own, named after the test and removed afterwards.
+ */
+class temp_directory_test : public ::testing::Test {
+  protected:
+    std::filesystem::path m_directory;
+
+    void SetUp() override {
+        const auto *test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_directory = std::filesystem::temp_directory_path() /
+                      (std::string(test_info->test_suite_name()) + "_" + test_info->name());
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_directory);
+    }
+};
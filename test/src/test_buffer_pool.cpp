@@ -0,0 +1,66 @@
+#include "utils/buffer_pool.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+
+TEST(buffer_pool_test, reuses_released_blocks) {
+    game_engine::buffer_pool_t pool;
+
+    auto *first = pool.allocate(1000);
+    ASSERT_NE(first, nullptr);
+    pool.deallocate(first);
+
+    // Same size class, so the block released above comes back without a system allocation.
+    auto *second = pool.allocate(4000);
+    EXPECT_EQ(second, first);
+    pool.deallocate(second);
+
+    const auto statistics = pool.get_statistics();
+    EXPECT_EQ(statistics.m_allocations, 2);
+    EXPECT_EQ(statistics.m_reuses, 1);
+    EXPECT_EQ(statistics.m_system_allocations, 1);
+    EXPECT_EQ(statistics.m_cached_bytes, 4096);
+}
+
+TEST(buffer_pool_test, reallocate_keeps_contents) {
+    game_engine::buffer_pool_t pool;
+
+    auto *block = static_cast<unsigned char *>(pool.allocate(16));
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 16, 0);
+    std::memset(block, 0xAB, 16);
+
+    EXPECT_EQ(pool.reallocate(block, 4096), block);
+
+    auto *grown = static_cast<unsigned char *>(pool.reallocate(block, 100000));
+    ASSERT_NE(grown, nullptr);
+    for (size_t i = 0; i < 16; ++i) {
+        EXPECT_EQ(grown[i], 0xAB);
+    }
+    pool.deallocate(grown);
+}
+
+TEST(buffer_pool_test, trim_releases_cache) {
+    game_engine::buffer_pool_t pool;
+    pool.deallocate(pool.allocate(5000));
+    EXPECT_EQ(pool.get_statistics().m_cached_bytes, 8192);
+
+    pool.trim();
+    EXPECT_EQ(pool.get_statistics().m_cached_bytes, 0);
+}
+
+TEST(buffer_pool_test, frees_past_cache_budget) {
+    game_engine::buffer_pool_t pool(8192);
+    auto *first = pool.allocate(5000);
+    auto *second = pool.allocate(5000);
+    pool.deallocate(first);
+    pool.deallocate(second);
+
+    // Only the first block fits in the budget, the second goes back to the system.
+    EXPECT_EQ(pool.get_statistics().m_cached_bytes, 8192);
+    auto *third = pool.allocate(5000);
+    EXPECT_EQ(third, first);
+    EXPECT_EQ(pool.get_statistics().m_system_allocations, 2);
+    pool.deallocate(third);
+}
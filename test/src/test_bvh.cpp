@@ -0,0 +1,174 @@
+#include "utils/bvh.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+class bvh_test : public ::testing::Test {
+  protected:
+    std::mt19937 m_random{3};
+    game_engine::bvh_t m_bvh;
+    std::vector<uint32_t> m_handles;
+    std::vector<game_engine::aabb_t> m_boxes;
+
+    game_engine::aabb_t random_box(float range) {
+        std::uniform_real_distribution<float> positions(-range, range);
+        std::uniform_real_distribution<float> extents(0.1F, 2.0F);
+
+        const glm::vec3 center(positions(m_random), positions(m_random), positions(m_random));
+        game_engine::aabb_t ret;
+        ret.m_min = center - glm::vec3(extents(m_random));
+        ret.m_max = center + glm::vec3(extents(m_random));
+        return ret;
+    }
+
+    void fill(size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            m_boxes.push_back(random_box(50.0F));
+            m_handles.push_back(m_bvh.insert(m_boxes.back()));
+        }
+        m_bvh.update();
+    }
+
+    template <class predicate_t> std::vector<uint32_t> brute_force(predicate_t predicate) const {
+        std::vector<uint32_t> ret;
+        for (size_t i = 0; i < m_boxes.size(); ++i) {
+            if (predicate(m_boxes[i])) {
+                ret.push_back(m_handles[i]);
+            }
+        }
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+
+    static std::vector<uint32_t> sorted(std::vector<uint32_t> handles) {
+        std::sort(handles.begin(), handles.end());
+        return handles;
+    }
+
+    static game_engine::frustum_t make_frustum() {
+        const auto projection = glm::perspective(glm::radians(60.0F), 1.0F, 0.1F, 40.0F);
+        const auto view = glm::lookAt(glm::vec3(0.0F), glm::vec3(1.0F, 0.0F, -1.0F), glm::vec3(0.0F, 1.0F, 0.0F));
+        return game_engine::frustum_t(projection * view);
+    }
+
+    void expect_matches_brute_force() const {
+        const auto frustum = make_frustum();
+        std::vector<uint32_t> result;
+        m_bvh.query_frustum(frustum, result);
+        const auto expected = brute_force([&](const auto &box) { return frustum.intersects(box); });
+        EXPECT_EQ(sorted(result), expected);
+        EXPECT_FALSE(expected.empty());
+
+        result.clear();
+        const glm::vec3 center(5.0F, -3.0F, 10.0F);
+        const float radius = 15.0F;
+        m_bvh.query_sphere(center, radius, result);
+        EXPECT_EQ(sorted(result), brute_force([&](const auto &box) {
+                      const auto offset = center - glm::min(glm::max(center, box.m_min), box.m_max);
+                      return glm::dot(offset, offset) <= radius * radius;
+                  }));
+    }
+};
+
+} // namespace
+
+TEST_F(bvh_test, queries_match_brute_force) {
+    fill(2000);
+    expect_matches_brute_force();
+    EXPECT_LE(m_bvh.get_statistics().m_nodes, 2 * m_boxes.size());
+}
+
+TEST_F(bvh_test, refits_moved_objects) {
+    fill(2000);
+    const auto rebuilds = m_bvh.get_statistics().m_rebuilds;
+
+    // A few small moves refit the tree without degrading it enough to rebuild.
+    for (size_t i = 0; i < m_boxes.size(); i += 50) {
+        m_boxes[i].m_min.x += 0.5F;
+        m_boxes[i].m_max.x += 0.5F;
+        m_bvh.move(m_handles[i], m_boxes[i]);
+    }
+    m_bvh.update();
+
+    EXPECT_EQ(m_bvh.get_statistics().m_rebuilds, rebuilds);
+    EXPECT_EQ(m_bvh.get_statistics().m_refits, 1);
+    expect_matches_brute_force();
+}
+
+TEST_F(bvh_test, rebuilds_degraded_trees) {
+    fill(2000);
+    const auto rebuilds = m_bvh.get_statistics().m_rebuilds;
+
+    // Shuffling every object makes the old partition useless.
+    for (size_t i = 0; i < m_boxes.size(); ++i) {
+        m_boxes[i] = random_box(50.0F);
+        m_bvh.move(m_handles[i], m_boxes[i]);
+    }
+    m_bvh.update();
+
+    EXPECT_EQ(m_bvh.get_statistics().m_rebuilds, rebuilds + 1);
+    EXPECT_LE(m_bvh.get_statistics().m_cost, m_bvh.get_statistics().m_built_cost);
+    expect_matches_brute_force();
+}
+
+TEST_F(bvh_test, removes_and_reuses_handles) {
+    fill(100);
+    const auto removed = m_handles[10];
+    m_bvh.remove(removed);
+    m_boxes.erase(m_boxes.begin() + 10);
+    m_handles.erase(m_handles.begin() + 10);
+
+    m_boxes.push_back(random_box(50.0F));
+    m_handles.push_back(m_bvh.insert(m_boxes.back()));
+    EXPECT_EQ(m_handles.back(), removed);
+
+    m_bvh.update();
+    EXPECT_EQ(m_bvh.get_statistics().m_objects, 100);
+    expect_matches_brute_force();
+}
+
+TEST_F(bvh_test, ray_visits_nearest_first) {
+    // A row of boxes along -Z, the nearest being hit first prunes all the others.
+    for (int i = 0; i < 64; ++i) {
+        game_engine::aabb_t box;
+        box.m_min = glm::vec3(-0.5F, -0.5F, -static_cast<float>(i) * 2.0F - 1.5F);
+        box.m_max = glm::vec3(0.5F, 0.5F, -static_cast<float>(i) * 2.0F - 0.5F);
+        m_boxes.push_back(box);
+        m_handles.push_back(m_bvh.insert(box));
+    }
+    m_bvh.update();
+
+    size_t visits = 0;
+    const auto distance =
+        m_bvh.query_ray(glm::vec3(0.0F), glm::vec3(0.0F, 0.0F, -1.0F), 1000.0F, [&](uint32_t handle) {
+            ++visits;
+            return -m_boxes[handle].m_max.z;
+        });
+    EXPECT_FLOAT_EQ(distance, 0.5F);
+    EXPECT_LE(visits, game_engine::bvh_t::m_max_leaf_size);
+
+    std::vector<uint32_t> all;
+    m_bvh.query_ray(glm::vec3(0.0F), glm::vec3(0.0F, 0.0F, -1.0F), 1000.0F, all);
+    EXPECT_EQ(all.size(), m_boxes.size());
+
+    all.clear();
+    m_bvh.query_ray(glm::vec3(2.0F, 0.0F, 0.0F), glm::vec3(0.0F, 0.0F, -1.0F), 1000.0F, all);
+    EXPECT_TRUE(all.empty());
+}
+
+TEST(bvh_empty_test, answers_empty_queries) {
+    game_engine::bvh_t bvh;
+    bvh.update();
+
+    std::vector<uint32_t> result;
+    bvh.query_sphere(glm::vec3(0.0F), 1.0F, result);
+    EXPECT_TRUE(result.empty());
+    EXPECT_LT(bvh.query_ray(glm::vec3(0.0F), glm::vec3(1.0F, 0.0F, 0.0F), 1.0F, [](uint32_t) { return 0.0F; }),
+              0.0F);
+}
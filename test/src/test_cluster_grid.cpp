@@ -0,0 +1,143 @@
+#include "utils/cluster_grid.h"
+#include "utils/light_bounds.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t tiles_x = 16;
+constexpr uint32_t tiles_y = 9;
+constexpr uint32_t slices = 24;
+constexpr auto near = 0.1F;
+constexpr auto far = 100.0F;
+
+const auto projection = glm::perspective(glm::radians(45.0F), 16.0F / 9.0F, near, far);
+
+// Camera at the origin looking down -z.
+const auto view = glm::lookAt(glm::vec3(0.0F), glm::vec3(0.0F, 0.0F, -1.0F), glm::vec3(0.0F, 1.0F, 0.0F));
+
+std::vector<uint32_t> get_lights(const game_engine::cluster_grid_t &grid, uint32_t index) {
+    const auto &cluster = grid.get_clusters().at(index);
+    const auto &indices = grid.get_light_indices();
+    return {indices.begin() + cluster.m_offset, indices.begin() + cluster.m_offset + cluster.m_count};
+}
+
+} // namespace
+
+TEST(cluster_grid_test, slices_cover_near_to_far) {
+    game_engine::cluster_grid_t grid(tiles_x, tiles_y, slices);
+    grid.update(view, projection, nullptr, 0);
+
+    EXPECT_EQ(grid.get_slice(near), 0);
+    EXPECT_EQ(grid.get_slice(far * 0.999F), slices - 1);
+    EXPECT_EQ(grid.get_slice(far * 2.0F), slices - 1);
+    EXPECT_LT(grid.get_slice(1.0F), grid.get_slice(10.0F));
+
+    // Bounds of the slices under the screen center follow the slice depths.
+    const auto center = grid.get_cluster_index(tiles_x / 2, tiles_y / 2, grid.get_slice(10.0F));
+    EXPECT_LE(-grid.get_bounds(center).m_max.z, 10.0F);
+    EXPECT_GE(-grid.get_bounds(center).m_min.z, 10.0F);
+}
+
+TEST(cluster_grid_test, assigns_lights_to_overlapping_clusters) {
+    game_engine::cluster_grid_t grid(tiles_x, tiles_y, slices);
+    const std::vector<glm::vec4> spheres = {glm::vec4(0.0F, 0.0F, -10.0F, 1.0F), glm::vec4(0.0F, 0.0F, -50.0F, 1.0F),
+                                            glm::vec4(0.0F, 0.0F, 10.0F, 1.0F)};
+    grid.update(view, projection, spheres.data(), spheres.size());
+
+    const auto near_cluster = grid.get_cluster_index(tiles_x / 2, tiles_y / 2, grid.get_slice(10.0F));
+    const auto far_cluster = grid.get_cluster_index(tiles_x / 2, tiles_y / 2, grid.get_slice(50.0F));
+    EXPECT_EQ(get_lights(grid, near_cluster), std::vector<uint32_t>{0});
+    EXPECT_EQ(get_lights(grid, far_cluster), std::vector<uint32_t>{1});
+
+    // Nothing reaches the corners, and the light behind the camera is nowhere.
+    EXPECT_EQ(grid.get_clusters().at(grid.get_cluster_index(0, 0, grid.get_slice(10.0F))).m_count, 0);
+    for (const auto index : grid.get_light_indices()) {
+        EXPECT_NE(index, 2);
+    }
+}
+
+TEST(cluster_grid_test, lights_reaching_the_camera_cover_the_near_slices) {
+    game_engine::cluster_grid_t grid(tiles_x, tiles_y, slices);
+    const std::vector<glm::vec4> spheres = {glm::vec4(0.0F, 0.0F, 0.0F, 5.0F)};
+    grid.update(view, projection, spheres.data(), spheres.size());
+
+    for (uint32_t y = 0; y < tiles_y; ++y) {
+        for (uint32_t x = 0; x < tiles_x; ++x) {
+            EXPECT_EQ(get_lights(grid, grid.get_cluster_index(x, y, 0)), std::vector<uint32_t>{0});
+        }
+    }
+    EXPECT_EQ(grid.get_clusters().at(grid.get_cluster_index(0, 0, slices - 1)).m_count, 0);
+}
+
+TEST(cluster_grid_test, ranges_are_contiguous) {
+    game_engine::cluster_grid_t grid(tiles_x, tiles_y, slices);
+    std::vector<glm::vec4> spheres;
+    for (int i = 0; i < 100; ++i) {
+        spheres.emplace_back(static_cast<float>(i % 10) - 5.0F, static_cast<float>(i / 10) - 5.0F,
+                             -5.0F - static_cast<float>(i), 2.0F);
+    }
+    grid.update(view, projection, spheres.data(), spheres.size());
+
+    uint32_t offset = 0;
+    for (const auto &cluster : grid.get_clusters()) {
+        EXPECT_EQ(cluster.m_offset, offset);
+        offset += cluster.m_count;
+        const auto lights = std::vector<uint32_t>(grid.get_light_indices().begin() + cluster.m_offset,
+                                                  grid.get_light_indices().begin() + offset);
+        EXPECT_TRUE(std::is_sorted(lights.begin(), lights.end()));
+    }
+    EXPECT_EQ(offset, grid.get_light_indices().size());
+}
+
+TEST(light_bounds_test, attenuation_radius) {
+    // 1 / (1 + 0.09 d + 0.032 d^2) reaches 1/256 around 84.
+    const auto radius = game_engine::attenuation_radius(1.0F, 0.09F, 0.032F, 1.0F / 256.0F);
+    EXPECT_NEAR(1.0F / (1.0F + 0.09F * radius + 0.032F * radius * radius), 1.0F / 256.0F, 1e-6F);
+
+    EXPECT_FLOAT_EQ(game_engine::attenuation_radius(1.0F, 1.0F, 0.0F, 0.5F), 1.0F);
+    EXPECT_FLOAT_EQ(game_engine::attenuation_radius(4.0F, 1.0F, 1.0F, 0.5F), 0.0F);
+    EXPECT_EQ(game_engine::attenuation_radius(1.0F, 0.0F, 0.0F, 0.5F), std::numeric_limits<float>::max());
+}
+
+TEST(light_bounds_test, spot_bounding_sphere_contains_cone) {
+    const glm::vec3 position(1.0F, 2.0F, 3.0F);
+    const glm::vec3 direction(0.0F, 0.0F, -1.0F);
+    for (const auto angle : {10.0F, 30.0F, 45.0F, 60.0F, 89.0F, 120.0F}) {
+        const auto cos_cutoff = std::cos(glm::radians(angle));
+        const auto sphere = game_engine::spot_bounding_sphere(position, direction, 10.0F, cos_cutoff);
+        EXPECT_LE(sphere.w, 10.0F + 1e-4F);
+
+        // Apex, tip and rim.
+        const auto sin_cutoff = std::sqrt(std::max(0.0F, 1.0F - cos_cutoff * cos_cutoff));
+        for (const auto &point : {position, position + direction * 10.0F,
+                                  position + glm::vec3(sin_cutoff, 0.0F, -cos_cutoff) * 10.0F}) {
+            EXPECT_LE(glm::distance(glm::vec3(sphere), point), sphere.w + 1e-4F) << angle;
+        }
+    }
+}
+
+TEST(light_bounds_test, gather_lights) {
+    game_engine::aabb_t box;
+    box.merge(glm::vec3(-1.0F));
+    box.merge(glm::vec3(1.0F));
+
+    // Touching a face, missing a corner by a little, and inside.
+    const std::vector<glm::vec4> spheres = {glm::vec4(3.0F, 0.0F, 0.0F, 2.0F), glm::vec4(2.0F, 2.0F, 2.0F, 1.7F),
+                                            glm::vec4(0.0F, 0.0F, 0.0F, 0.1F)};
+    const std::vector<uint32_t> candidates = {0, 1, 2};
+    std::vector<uint32_t> lights = {7};
+    EXPECT_TRUE(game_engine::gather_lights(box, spheres.data(), candidates, 2, lights));
+    EXPECT_EQ(lights, (std::vector<uint32_t>{7, 0, 2}));
+
+    EXPECT_FALSE(game_engine::gather_lights(box, spheres.data(), candidates, 1, lights));
+    EXPECT_EQ(lights, (std::vector<uint32_t>{7, 0, 2}));
+
+    // Lights left out of the candidates are never tested.
+    EXPECT_TRUE(game_engine::gather_lights(box, spheres.data(), {2}, 1, lights));
+    EXPECT_EQ(lights, (std::vector<uint32_t>{7, 0, 2, 2}));
+}
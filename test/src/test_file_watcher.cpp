@@ -0,0 +1,48 @@
+#include "temp_directory_test.h"
+#include "utils/exception.h"
+#include "utils/file_watcher.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+class file_watcher_test : public temp_directory_test {
+  protected:
+    void write(const std::filesystem::path &path, const char *contents) const {
+        std::ofstream file(m_directory / path);
+        file << contents;
+    }
+};
+
+} // namespace
+
+TEST_F(file_watcher_test, reports_written_files_once) {
+    game_engine::file_watcher_t watcher(m_directory);
+    EXPECT_TRUE(watcher.poll().empty());
+
+    write("object.frag", "first");
+    write("object.frag", "second");
+
+    const auto changes = watcher.poll();
+    ASSERT_EQ(changes.size(), 1);
+    EXPECT_EQ(changes[0], "object.frag");
+    EXPECT_TRUE(watcher.poll().empty());
+}
+
+TEST_F(file_watcher_test, reports_renamed_files) {
+    game_engine::file_watcher_t watcher(m_directory);
+
+    write("object.frag.swp", "contents");
+    watcher.poll();
+    std::filesystem::rename(m_directory / "object.frag.swp", m_directory / "object.frag");
+
+    const auto changes = watcher.poll();
+    ASSERT_EQ(changes.size(), 1);
+    EXPECT_EQ(changes[0], "object.frag");
+}
+
+TEST(file_watcher_missing_test, throws_for_missing_directories) {
+    EXPECT_THROW(game_engine::file_watcher_t("/nonexistent/directory"), game_engine::exception_t);
+}
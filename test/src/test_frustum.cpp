@@ -0,0 +1,82 @@
+#include "test_helpers.h"
+#include "utils/frustum.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Camera at the origin looking down -Z, as the default view.
+game_engine::frustum_t make_frustum() {
+    return game_engine::frustum_t(make_view_projection());
+}
+
+} // namespace
+
+TEST(frustum_test, keeps_boxes_in_view) {
+    const auto frustum = make_frustum();
+    EXPECT_TRUE(frustum.intersects(make_box({0.0F, 0.0F, -5.0F}, 0.5F)));
+    EXPECT_TRUE(frustum.intersects(make_box({0.0F, 0.0F, -99.0F}, 0.5F)));
+}
+
+TEST(frustum_test, culls_boxes_out_of_view) {
+    const auto frustum = make_frustum();
+    EXPECT_FALSE(frustum.intersects(make_box({0.0F, 0.0F, 5.0F}, 0.5F)));
+    EXPECT_FALSE(frustum.intersects(make_box({50.0F, 0.0F, -5.0F}, 0.5F)));
+    EXPECT_FALSE(frustum.intersects(make_box({0.0F, -50.0F, -5.0F}, 0.5F)));
+    EXPECT_FALSE(frustum.intersects(make_box({0.0F, 0.0F, -200.0F}, 0.5F)));
+}
+
+TEST(frustum_test, keeps_boxes_straddling_a_plane) {
+    const auto frustum = make_frustum();
+    EXPECT_TRUE(frustum.intersects(make_box({0.0F, 0.0F, 0.0F}, 1.0F)));
+    EXPECT_TRUE(frustum.intersects(make_box({0.0F, 0.0F, -100.0F}, 1.0F)));
+}
+
+TEST(frustum_test, batch_matches_single_tests) {
+    const auto frustum = make_frustum();
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> positions(-60.0F, 60.0F);
+    std::uniform_real_distribution<float> extents(0.1F, 5.0F);
+
+    // 103 boxes covers both the vectorized blocks and the scalar tail.
+    std::vector<game_engine::aabb_t> boxes;
+    for (int i = 0; i < 103; ++i) {
+        boxes.push_back(make_box({positions(random), positions(random), positions(random)}, extents(random)));
+    }
+
+    std::vector<uint8_t> visible(boxes.size());
+    const auto visible_count = frustum.intersects(boxes.data(), boxes.size(), visible.data());
+
+    size_t expected_count = 0;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        EXPECT_EQ(visible[i] != 0, frustum.intersects(boxes[i])) << "box " << i;
+        expected_count += frustum.intersects(boxes[i]) ? 1 : 0;
+    }
+    EXPECT_EQ(visible_count, expected_count);
+    EXPECT_GT(visible_count, 0);
+    EXPECT_LT(visible_count, boxes.size());
+}
+
+TEST(aabb_test, transforms_to_enclosing_box) {
+    const auto box = make_box(glm::vec3(0.0F), 1.0F);
+    auto transform = glm::translate(glm::mat4(1.0F), glm::vec3(10.0F, 0.0F, 0.0F));
+    transform = glm::rotate(transform, glm::radians(45.0F), glm::vec3(0.0F, 0.0F, 1.0F));
+    transform = glm::scale(transform, glm::vec3(2.0F));
+
+    const auto world = box.transform(transform);
+    const auto expected_extent = 2.0F * std::sqrt(2.0F);
+    EXPECT_NEAR(world.m_min.x, 10.0F - expected_extent, 1e-4F);
+    EXPECT_NEAR(world.m_max.x, 10.0F + expected_extent, 1e-4F);
+    EXPECT_NEAR(world.m_min.y, -expected_extent, 1e-4F);
+    EXPECT_NEAR(world.m_max.z, 2.0F, 1e-4F);
+}
+
+TEST(aabb_test, empty_until_merged) {
+    game_engine::aabb_t box;
+    EXPECT_TRUE(box.is_empty());
+    box.merge(glm::vec3(1.0F, 2.0F, 3.0F));
+    EXPECT_FALSE(box.is_empty());
+    EXPECT_EQ(box.get_center(), glm::vec3(1.0F, 2.0F, 3.0F));
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "utils/aabb.h"
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/glm.hpp>
+
+/**
+ * @brief Builds a cube.
+ * @param center Center of the cube.
+ * @param half_size Distance from the center to each face.
+ */
+inline game_engine::aabb_t make_box(const glm::vec3 &center, float half_size) {
+    game_engine::aabb_t ret;
+    ret.m_min = center - glm::vec3(half_size);
+    ret.m_max = center + glm::vec3(half_size);
+    return ret;
+}
+
+/**
+ * @brief Builds the view projection of a 16:9 camera at the origin looking down -z, seeing from 0.1 to 100 units.
+ * @param fov_degrees Vertical field of view.
+ */
+inline glm::mat4 make_view_projection(float fov_degrees = 45.0F) {
+    const auto projection = glm::perspective(glm::radians(fov_degrees), 16.0F / 9.0F, 0.1F, 100.0F);
+    return projection * glm::lookAt(glm::vec3(0.0F), glm::vec3(0.0F, 0.0F, -1.0F), glm::vec3(0.0F, 1.0F, 0.0F));
+}
@@ -0,0 +1,66 @@
+#include "utils/light_store.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using game_engine::light_store_t;
+using game_engine::light_t;
+using game_engine::light_type_t;
+
+namespace {
+
+light_t make_light(light_type_t type, float x) {
+    light_t ret;
+    ret.m_type = type;
+    ret.m_position = glm::vec3(x, 0.0F, 0.0F);
+    return ret;
+}
+
+} // namespace
+
+TEST(light_store_test, keeps_types_contiguous) {
+    light_store_t store;
+    const std::vector<light_type_t> types = {light_type_t::spot,    light_type_t::ambient, light_type_t::directional,
+                                             light_type_t::ambient, light_type_t::spot,    light_type_t::directional};
+    for (size_t i = 0; i < types.size(); ++i) {
+        store.add(make_light(types[i], static_cast<float>(i)));
+    }
+
+    ASSERT_EQ(store.size(), types.size());
+    for (const auto type : {light_type_t::ambient, light_type_t::directional, light_type_t::spot}) {
+        EXPECT_EQ(store.get_count(type), 2U);
+        for (auto slot = store.get_first(type); slot < store.get_first(type) + store.get_count(type); ++slot) {
+            EXPECT_EQ(store.get(store.get_handles()[slot]).m_type, type);
+        }
+    }
+    EXPECT_EQ(store.get_first(light_type_t::ambient), 0U);
+    EXPECT_EQ(store.get_first(light_type_t::directional), 2U);
+    EXPECT_EQ(store.get_first(light_type_t::spot), 4U);
+}
+
+TEST(light_store_test, handles_are_stable) {
+    light_store_t store;
+    std::vector<light_store_t::handle_t> handles;
+    for (size_t i = 0; i < 30; ++i) {
+        const auto type = static_cast<light_type_t>(3 - i % 3);
+        handles.emplace_back(store.add(make_light(type, static_cast<float>(i))));
+    }
+
+    for (size_t i = 0; i < handles.size(); ++i) {
+        EXPECT_EQ(store.get(handles[i]).m_position.x, static_cast<float>(i));
+        EXPECT_EQ(store.get_handles()[store.get_slot(handles[i])], handles[i]);
+        EXPECT_EQ(store.get_columns().m_position[store.get_slot(handles[i])].x, static_cast<float>(i));
+    }
+
+    auto light = store.get(handles[7]);
+    light.m_diffuse = glm::vec3(0.5F);
+    store.set(handles[7], light);
+    EXPECT_EQ(store.get(handles[7]).m_diffuse.y, 0.5F);
+    EXPECT_EQ(store.get(handles[8]).m_diffuse.y, 0.0F);
+}
+
+TEST(light_store_test, rejects_deactivated_lights) {
+    light_store_t store;
+    EXPECT_EQ(store.add(make_light(light_type_t::deactivated, 0.0F)), light_store_t::m_invalid_handle);
+    EXPECT_EQ(store.size(), 0U);
+}
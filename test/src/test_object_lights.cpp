@@ -0,0 +1,126 @@
+#include "utils/object_lights.h"
+#include "gtest/gtest.h"
+
+#include "test_helpers.h"
+#include "utils/light_bounds.h"
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t max_lights = 4;
+
+class object_lights_test : public ::testing::Test {
+  protected:
+    std::mt19937 m_random{5};
+    game_engine::bvh_t m_bvh;
+    std::vector<game_engine::aabb_t> m_boxes;
+    std::vector<glm::vec4> m_spheres;
+    game_engine::object_lights_t m_lights{max_lights};
+
+    glm::vec3 random_position() {
+        std::uniform_real_distribution<float> positions(-30.0F, 30.0F);
+        return {positions(m_random), positions(m_random), positions(m_random)};
+    }
+
+    void fill(size_t object_count, size_t light_count) {
+        std::uniform_real_distribution<float> sizes(0.5F, 3.0F);
+        for (size_t i = 0; i < object_count; ++i) {
+            m_boxes.push_back(make_box(random_position(), sizes(m_random)));
+            m_bvh.insert(m_boxes.back());
+        }
+        for (size_t i = 0; i < light_count; ++i) {
+            m_spheres.emplace_back(random_position(), 2.0F * sizes(m_random));
+        }
+    }
+
+    void update() {
+        m_bvh.update();
+        m_lights.update(m_bvh, m_boxes.size(), m_spheres.data(), m_spheres.size());
+    }
+
+    // Compares every list to testing the object against every light.
+    void expect_brute_force() const {
+        std::vector<uint32_t> candidates(m_spheres.size());
+        std::iota(candidates.begin(), candidates.end(), 0);
+        for (uint32_t i = 0; i < m_boxes.size(); ++i) {
+            std::vector<uint32_t> expected;
+            const auto fits =
+                game_engine::gather_lights(m_boxes[i], m_spheres.data(), candidates, max_lights, expected);
+            const auto list = m_lights.get_lights(i);
+            EXPECT_EQ(list.m_overflow, !fits) << i;
+            EXPECT_EQ(std::vector<uint32_t>(list.m_lights, list.m_lights + list.m_count), expected) << i;
+        }
+    }
+};
+
+TEST_F(object_lights_test, matches_brute_force) {
+    fill(300, 100);
+    update();
+    EXPECT_EQ(m_lights.get_statistics().m_updated_objects, m_boxes.size());
+    expect_brute_force();
+
+    // Move some objects and lights, add lights, then remove some.
+    for (size_t frame = 0; frame < 4; ++frame) {
+        for (size_t i = 0; i < 20; ++i) {
+            const auto object = m_random() % m_boxes.size();
+            m_boxes[object] = make_box(random_position(), 1.0F);
+            m_bvh.move(static_cast<uint32_t>(object), m_boxes[object]);
+            m_spheres[m_random() % m_spheres.size()] = glm::vec4(random_position(), 4.0F);
+        }
+        if (frame < 2) {
+            m_spheres.emplace_back(random_position(), 5.0F);
+        } else {
+            m_spheres.resize(m_spheres.size() - 10);
+        }
+        update();
+        expect_brute_force();
+    }
+}
+
+TEST_F(object_lights_test, only_updates_what_moved) {
+    m_boxes = {make_box(glm::vec3(0.0F), 1.0F), make_box(glm::vec3(10.0F, 0.0F, 0.0F), 1.0F),
+               make_box(glm::vec3(20.0F, 0.0F, 0.0F), 1.0F)};
+    for (const auto &box : m_boxes) {
+        m_bvh.insert(box);
+    }
+    m_spheres = {glm::vec4(0.0F, 0.0F, 0.0F, 2.0F), glm::vec4(20.0F, 0.0F, 0.0F, 2.0F)};
+    update();
+    EXPECT_EQ(m_lights.get_statistics().m_updated_objects, 3);
+
+    update();
+    EXPECT_EQ(m_lights.get_statistics().m_changed_lights, 0);
+    EXPECT_EQ(m_lights.get_statistics().m_updated_objects, 0);
+
+    // The first light moves from the first object to the second, leaving the third alone.
+    m_spheres[0] = glm::vec4(10.0F, 0.0F, 0.0F, 2.0F);
+    update();
+    EXPECT_EQ(m_lights.get_statistics().m_changed_lights, 1);
+    EXPECT_EQ(m_lights.get_statistics().m_updated_objects, 2);
+    EXPECT_EQ(m_lights.get_lights(0).m_count, 0);
+    ASSERT_EQ(m_lights.get_lights(1).m_count, 1);
+    EXPECT_EQ(m_lights.get_lights(1).m_lights[0], 0);
+
+    m_boxes[2] = make_box(glm::vec3(30.0F, 0.0F, 0.0F), 1.0F);
+    m_bvh.move(2, m_boxes[2]);
+    update();
+    EXPECT_EQ(m_lights.get_statistics().m_updated_objects, 1);
+    EXPECT_EQ(m_lights.get_lights(2).m_count, 0);
+}
+
+TEST_F(object_lights_test, overflows) {
+    m_boxes = {make_box(glm::vec3(0.0F), 1.0F)};
+    m_bvh.insert(m_boxes[0]);
+    m_spheres.assign(max_lights, glm::vec4(0.0F, 0.0F, 0.0F, 1.0F));
+    update();
+    EXPECT_FALSE(m_lights.get_lights(0).m_overflow);
+    EXPECT_EQ(m_lights.get_lights(0).m_count, max_lights);
+
+    m_spheres.emplace_back(1.5F, 0.0F, 0.0F, 1.0F);
+    update();
+    EXPECT_TRUE(m_lights.get_lights(0).m_overflow);
+    EXPECT_EQ(m_lights.get_lights(0).m_count, 0);
+}
+
+} // namespace
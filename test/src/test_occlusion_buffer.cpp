@@ -0,0 +1,130 @@
+#include "test_helpers.h"
+#include "utils/occlusion_buffer.h"
+#include "gtest/gtest.h"
+
+#include <array>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t width = 64;
+constexpr size_t height = 36;
+constexpr auto fov_degrees = 60.0F;
+
+// Square in the z = depth plane, as two triangles.
+void rasterize_wall(game_engine::occlusion_buffer_t &buffer, const glm::mat4 &view_projection, float depth,
+                    float half_size) {
+    const std::array<glm::vec3, 4> positions = {
+        glm::vec3(-half_size, -half_size, depth), glm::vec3(half_size, -half_size, depth),
+        glm::vec3(half_size, half_size, depth), glm::vec3(-half_size, half_size, depth)};
+    const std::array<uint32_t, 6> indices = {0, 1, 2, 0, 2, 3};
+    buffer.rasterize(view_projection, positions.data(), indices.data(), indices.size());
+}
+
+} // namespace
+
+TEST(occlusion_buffer_test, empty_buffer_hides_nothing) {
+    game_engine::occlusion_buffer_t buffer(width, height);
+    const auto view_projection = make_view_projection(fov_degrees);
+
+    EXPECT_TRUE(buffer.is_visible(make_box(glm::vec3(0.0F, 0.0F, -50.0F), 1.0F), view_projection));
+    EXPECT_FLOAT_EQ(buffer.get_depth(0, 0), 1.0F);
+}
+
+TEST(occlusion_buffer_test, wall_hides_boxes_behind_it) {
+    game_engine::occlusion_buffer_t buffer(width, height);
+    const auto view_projection = make_view_projection(fov_degrees);
+    rasterize_wall(buffer, view_projection, -5.0F, 4.0F);
+    EXPECT_EQ(buffer.get_statistics().m_occluder_triangles, 2);
+    EXPECT_LT(buffer.get_depth(width / 2, height / 2), 1.0F);
+
+    EXPECT_FALSE(buffer.is_visible(make_box(glm::vec3(0.0F, 0.0F, -20.0F), 1.0F), view_projection));
+    EXPECT_TRUE(buffer.is_visible(make_box(glm::vec3(0.0F, 0.0F, -3.0F), 0.5F), view_projection));
+    EXPECT_TRUE(buffer.is_visible(make_box(glm::vec3(20.0F, 0.0F, -20.0F), 1.0F), view_projection));
+
+    // Straddling the wall.
+    EXPECT_TRUE(buffer.is_visible(make_box(glm::vec3(0.0F, 0.0F, -5.0F), 1.0F), view_projection));
+    EXPECT_EQ(buffer.get_statistics().m_occluded, 1);
+}
+
+TEST(occlusion_buffer_test, partial_coverage_does_not_occlude) {
+    game_engine::occlusion_buffer_t buffer(width, height);
+    const auto view_projection = make_view_projection(fov_degrees);
+
+    // The box is larger than the wall on screen, so its edges stay visible around it.
+    rasterize_wall(buffer, view_projection, -5.0F, 0.5F);
+    EXPECT_TRUE(buffer.is_visible(make_box(glm::vec3(0.0F, 0.0F, -20.0F), 4.0F), view_projection));
+}
+
+TEST(occlusion_buffer_test, winding_does_not_matter) {
+    game_engine::occlusion_buffer_t buffer(width, height);
+    const auto view_projection = make_view_projection(fov_degrees);
+
+    const std::array<glm::vec3, 3> positions = {glm::vec3(-10.0F, -10.0F, -5.0F), glm::vec3(10.0F, 10.0F, -5.0F),
+                                                glm::vec3(10.0F, -10.0F, -5.0F)};
+    const std::array<uint32_t, 3> indices = {0, 1, 2};
+    buffer.rasterize(view_projection, positions.data(), indices.data(), indices.size());
+    EXPECT_LT(buffer.get_depth(width - 1, 0), 1.0F);
+    EXPECT_FLOAT_EQ(buffer.get_depth(0, height - 1), 1.0F);
+}
+
+TEST(occlusion_buffer_test, near_plane_is_conservative) {
+    game_engine::occlusion_buffer_t buffer(width, height);
+    const auto view_projection = make_view_projection(fov_degrees);
+
+    // Occluders reaching behind the camera are skipped, and boxes reaching it are always visible.
+    const std::array<glm::vec3, 3> positions = {glm::vec3(-10.0F, -10.0F, 5.0F), glm::vec3(10.0F, -10.0F, -5.0F),
+                                                glm::vec3(0.0F, 10.0F, -5.0F)};
+    const std::array<uint32_t, 3> indices = {0, 1, 2};
+    buffer.rasterize(view_projection, positions.data(), indices.data(), indices.size());
+    EXPECT_EQ(buffer.get_statistics().m_occluder_triangles, 0);
+
+    rasterize_wall(buffer, view_projection, -5.0F, 4.0F);
+    EXPECT_TRUE(buffer.is_visible(make_box(glm::vec3(0.0F, 0.0F, -10.0F), 10.0F), view_projection));
+}
+
+TEST(occlusion_buffer_test, clear_resets_depth) {
+    game_engine::occlusion_buffer_t buffer(width, height);
+    const auto view_projection = make_view_projection(fov_degrees);
+    rasterize_wall(buffer, view_projection, -5.0F, 4.0F);
+
+    buffer.clear();
+    EXPECT_FLOAT_EQ(buffer.get_depth(width / 2, height / 2), 1.0F);
+    EXPECT_TRUE(buffer.is_visible(make_box(glm::vec3(0.0F, 0.0F, -20.0F), 1.0F), view_projection));
+}
+
+TEST(occlusion_buffer_test, scalar_kernels_match_vectorized) {
+    using game_engine::occlusion_buffer_t;
+
+    // A width that is not a multiple of four leaves partial blocks at the end of each row.
+    const size_t odd_width = 61;
+    occlusion_buffer_t scalar(odd_width, height, occlusion_buffer_t::kernels_t::scalar);
+    occlusion_buffer_t vectorized(odd_width, height, occlusion_buffer_t::kernels_t::vectorized);
+    const auto view_projection = make_view_projection(fov_degrees);
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> lateral(-15.0F, 15.0F);
+    std::uniform_real_distribution<float> depths(-40.0F, -2.0F);
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < 300; ++i) {
+        positions.emplace_back(lateral(random), lateral(random), depths(random));
+        indices.emplace_back(i);
+    }
+    scalar.rasterize(view_projection, positions.data(), indices.data(), indices.size());
+    vectorized.rasterize(view_projection, positions.data(), indices.data(), indices.size());
+
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < odd_width; ++x) {
+            ASSERT_EQ(scalar.get_depth(x, y), vectorized.get_depth(x, y)) << "at " << x << ", " << y;
+        }
+    }
+
+    std::uniform_real_distribution<float> sizes(0.1F, 2.0F);
+    for (size_t i = 0; i < 500; ++i) {
+        const auto box = make_box(glm::vec3(lateral(random), lateral(random), depths(random)), sizes(random));
+        EXPECT_EQ(scalar.is_visible(box, view_projection), vectorized.is_visible(box, view_projection));
+    }
+    EXPECT_GT(scalar.get_statistics().m_occluded, 0);
+}
@@ -0,0 +1,79 @@
+#include "utils/pixel_kernels.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+std::vector<unsigned char> sequence(size_t size) {
+    std::vector<unsigned char> ret(size);
+    std::iota(ret.begin(), ret.end(), static_cast<unsigned char>(0));
+    return ret;
+}
+
+} // namespace
+
+TEST(pixel_kernels_test, expand_rgb_to_rgba) {
+    // 37 pixels covers both the vectorized blocks and the scalar tail.
+    const size_t pixel_count = 37;
+    const auto rgb = sequence(pixel_count * 3);
+    std::vector<unsigned char> rgba(pixel_count * 4);
+
+    game_engine::expand_rgb_to_rgba(rgb.data(), rgba.data(), pixel_count);
+
+    for (size_t i = 0; i < pixel_count; ++i) {
+        EXPECT_EQ(rgba[i * 4 + 0], rgb[i * 3 + 0]);
+        EXPECT_EQ(rgba[i * 4 + 1], rgb[i * 3 + 1]);
+        EXPECT_EQ(rgba[i * 4 + 2], rgb[i * 3 + 2]);
+        EXPECT_EQ(rgba[i * 4 + 3], 255);
+    }
+}
+
+TEST(pixel_kernels_test, flip_vertically) {
+    const size_t row_bytes = 21;
+    const size_t rows = 5;
+    const auto original = sequence(row_bytes * rows);
+    auto flipped = original;
+
+    game_engine::flip_vertically(flipped.data(), row_bytes, rows);
+
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t i = 0; i < row_bytes; ++i) {
+            EXPECT_EQ(flipped[row * row_bytes + i], original[(rows - 1 - row) * row_bytes + i]);
+        }
+    }
+}
+
+TEST(pixel_kernels_test, premultiply_alpha) {
+    const size_t pixel_count = 256 + 3;
+    std::vector<unsigned char> pixels(pixel_count * 4);
+    for (size_t i = 0; i < pixel_count; ++i) {
+        pixels[i * 4 + 0] = 255;
+        pixels[i * 4 + 1] = static_cast<unsigned char>(i);
+        pixels[i * 4 + 2] = 0;
+        pixels[i * 4 + 3] = static_cast<unsigned char>(i);
+    }
+
+    game_engine::premultiply_alpha(pixels.data(), pixel_count);
+
+    for (size_t i = 0; i < pixel_count; ++i) {
+        const auto alpha = static_cast<unsigned char>(i);
+        EXPECT_EQ(pixels[i * 4 + 0], alpha);
+        EXPECT_EQ(pixels[i * 4 + 1], static_cast<unsigned char>(std::lround(alpha * alpha / 255.0)));
+        EXPECT_EQ(pixels[i * 4 + 2], 0);
+        EXPECT_EQ(pixels[i * 4 + 3], alpha);
+    }
+}
+
+TEST(pixel_kernels_test, srgb_to_linear) {
+    std::vector<unsigned char> pixels = {0, 128, 255, 128};
+
+    game_engine::srgb_to_linear(pixels.data(), 1);
+
+    EXPECT_EQ(pixels[0], 0);
+    EXPECT_EQ(pixels[1], 55);
+    EXPECT_EQ(pixels[2], 255);
+    EXPECT_EQ(pixels[3], 128);
+}
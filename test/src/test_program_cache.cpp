@@ -0,0 +1,107 @@
+#include "temp_directory_test.h"
+#include "utils/program_cache.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+
+using program_cache_test = temp_directory_test;
+
+TEST_F(program_cache_test, stores_and_loads_binaries) {
+    game_engine::program_cache_t cache(m_directory);
+    const auto key = game_engine::program_cache_t::make_key({"vert", "frag"}, "driver");
+
+    EXPECT_FALSE(cache.load(key));
+
+    game_engine::program_binary_t binary;
+    binary.m_format = 0x1234;
+    binary.m_data = {1, 2, 3, 4, 5};
+    cache.store(key, binary);
+
+    const auto loaded = cache.load(key);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(loaded->m_format, binary.m_format);
+    EXPECT_EQ(loaded->m_data, binary.m_data);
+
+    EXPECT_EQ(cache.get_statistics().m_hits, 1);
+    EXPECT_EQ(cache.get_statistics().m_misses, 1);
+}
+
+TEST_F(program_cache_test, rejected_binaries_are_dropped) {
+    game_engine::program_cache_t cache(m_directory);
+    const auto key = game_engine::program_cache_t::make_key({"vert", "frag"}, "driver");
+
+    game_engine::program_binary_t binary;
+    binary.m_data = {1, 2, 3};
+    cache.store(key, binary);
+    cache.reject(key);
+
+    EXPECT_FALSE(cache.load(key));
+    EXPECT_EQ(cache.get_statistics().m_rejections, 1);
+}
+
+TEST_F(program_cache_test, truncated_files_are_ignored) {
+    game_engine::program_cache_t cache(m_directory);
+    const auto key = game_engine::program_cache_t::make_key({"vert", "frag"}, "driver");
+
+    game_engine::program_binary_t binary;
+    binary.m_data = std::vector<uint8_t>(100, 7);
+    cache.store(key, binary);
+
+    for (const auto &entry : std::filesystem::directory_iterator(m_directory)) {
+        std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) - 10);
+    }
+
+    EXPECT_FALSE(cache.load(key));
+}
+
+TEST_F(program_cache_test, oversized_headers_are_ignored) {
+    game_engine::program_cache_t cache(m_directory);
+    const auto key = game_engine::program_cache_t::make_key({"vert", "frag"}, "driver");
+
+    game_engine::program_binary_t binary;
+    binary.m_data = {1, 2, 3};
+    cache.store(key, binary);
+
+    // Overwrites the size, the last member of the header, with the largest value it can hold.
+    for (const auto &entry : std::filesystem::directory_iterator(m_directory)) {
+        std::fstream file(entry.path(), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(20);
+        const uint32_t size = 0xFFFFFFFF;
+        file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    }
+
+    EXPECT_FALSE(cache.load(key));
+}
+
+TEST_F(program_cache_test, failed_stores_leave_no_files) {
+    game_engine::program_cache_t cache(m_directory);
+    const auto key = game_engine::program_cache_t::make_key({"vert", "frag"}, "driver");
+
+    game_engine::program_binary_t binary;
+    binary.m_data = {1, 2, 3};
+    cache.store(key, binary);
+
+    // A directory in place of the cache file makes the final rename fail.
+    const auto path = std::filesystem::directory_iterator(m_directory)->path();
+    std::filesystem::remove(path);
+    std::filesystem::create_directory(path);
+    cache.store(key, binary);
+
+    size_t count = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(m_directory)) {
+        EXPECT_EQ(entry.path(), path);
+        ++count;
+    }
+    EXPECT_EQ(count, 1);
+}
+
+TEST(program_cache_key_test, covers_sources_and_driver) {
+    using game_engine::program_cache_t;
+
+    const auto key = program_cache_t::make_key({"vert", "frag"}, "driver");
+    EXPECT_EQ(key, program_cache_t::make_key({"vert", "frag"}, "driver"));
+    EXPECT_NE(key, program_cache_t::make_key({"vert", "frag2"}, "driver"));
+    EXPECT_NE(key, program_cache_t::make_key({"vert", "frag"}, "driver2"));
+    EXPECT_NE(key, program_cache_t::make_key({"ver", "tfrag"}, "driver"));
+}
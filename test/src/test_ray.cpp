@@ -0,0 +1,34 @@
+#include "utils/ray.h"
+#include "gtest/gtest.h"
+
+#include <glm/ext/matrix_transform.hpp>
+
+namespace {
+
+const glm::vec3 v0(-1.0F, -1.0F, 0.0F);
+const glm::vec3 v1(1.0F, -1.0F, 0.0F);
+const glm::vec3 v2(0.0F, 1.0F, 0.0F);
+
+} // namespace
+
+TEST(ray_test, hits_triangle_from_both_sides) {
+    EXPECT_FLOAT_EQ(game_engine::intersect_triangle({{0.0F, 0.0F, 5.0F}, {0.0F, 0.0F, -1.0F}}, v0, v1, v2), 5.0F);
+    EXPECT_FLOAT_EQ(game_engine::intersect_triangle({{0.0F, 0.0F, -5.0F}, {0.0F, 0.0F, 2.0F}}, v0, v1, v2), 2.5F);
+}
+
+TEST(ray_test, misses_triangle) {
+    // Beside the triangle, parallel to it, and pointing away from it.
+    EXPECT_LT(game_engine::intersect_triangle({{2.0F, 0.0F, 5.0F}, {0.0F, 0.0F, -1.0F}}, v0, v1, v2), 0.0F);
+    EXPECT_LT(game_engine::intersect_triangle({{0.0F, 0.0F, 5.0F}, {1.0F, 0.0F, 0.0F}}, v0, v1, v2), 0.0F);
+    EXPECT_LT(game_engine::intersect_triangle({{0.0F, 0.0F, 5.0F}, {0.0F, 0.0F, 1.0F}}, v0, v1, v2), 0.0F);
+}
+
+TEST(ray_test, transform_preserves_distances) {
+    auto transform = glm::translate(glm::mat4(1.0F), glm::vec3(3.0F, 0.0F, 0.0F));
+    transform = glm::scale(transform, glm::vec3(2.0F));
+
+    // The triangle placed by the transform is hit at the same distance as the ray moved into its space.
+    const game_engine::ray_t ray{{3.0F, 0.0F, 10.0F}, {0.0F, 0.0F, -1.0F}};
+    const auto local = ray.transform(glm::inverse(transform));
+    EXPECT_FLOAT_EQ(game_engine::intersect_triangle(local, v0, v1, v2), 10.0F);
+}
@@ -0,0 +1,65 @@
+#include "utils/render_queue.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using game_engine::render_queue_t;
+
+TEST(render_queue_test, orders_by_program_then_material_then_vertex_array_then_depth) {
+    render_queue_t queue;
+    queue.push(render_queue_t::make_key(1, 0, 0, 0.0F), 0);
+    queue.push(render_queue_t::make_key(0, 1, 0, 0.0F), 1);
+    queue.push(render_queue_t::make_key(0, 0, 1, 0.0F), 2);
+    queue.push(render_queue_t::make_key(0, 0, 0, 1.0F), 3);
+    queue.push(render_queue_t::make_key(0, 0, 0, 0.5F), 4);
+
+    queue.sort();
+
+    std::vector<uint32_t> order;
+    for (const auto &item : queue.get_items()) {
+        order.push_back(item.m_index);
+    }
+    EXPECT_EQ(order, (std::vector<uint32_t>{4, 3, 2, 1, 0}));
+}
+
+TEST(render_queue_test, clamps_fields) {
+    EXPECT_EQ(render_queue_t::make_key(0, 0, 0, -1.0F), render_queue_t::make_key(0, 0, 0, 0.0F));
+    EXPECT_EQ(render_queue_t::make_key(0, 0, 0, 2.0F), render_queue_t::make_key(0, 0, 0, 1.0F));
+
+    // An overflowing identifier must not spill into the next field.
+    EXPECT_EQ(render_queue_t::make_key(0, 0, 1U << 20U, 1.0F),
+              render_queue_t::make_key(0, 0, (1U << render_queue_t::m_vertex_array_bits) - 1, 1.0F));
+    EXPECT_LT(render_queue_t::make_key(0, 0, 1U << 20U, 1.0F), render_queue_t::make_key(0, 1, 0, 0.0F));
+}
+
+TEST(render_queue_test, matches_stable_sort) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<uint32_t> ids(0, 7);
+    std::uniform_real_distribution<float> depths(0.0F, 1.0F);
+
+    render_queue_t queue;
+    std::vector<render_queue_t::item_t> expected;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        const auto key = render_queue_t::make_key(ids(random), ids(random), ids(random), depths(random));
+        queue.push(key, i);
+        expected.push_back({key, i});
+    }
+
+    queue.sort();
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto &lhs, const auto &rhs) { return lhs.m_key < rhs.m_key; });
+
+    ASSERT_EQ(queue.get_items().size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(queue.get_items()[i].m_key, expected[i].m_key);
+        EXPECT_EQ(queue.get_items()[i].m_index, expected[i].m_index);
+    }
+}
+
+TEST(render_queue_test, sorts_empty_queue) {
+    render_queue_t queue;
+    queue.sort();
+    EXPECT_TRUE(queue.get_items().empty());
+}
@@ -0,0 +1,99 @@
+#include "utils/static_groups.h"
+#include "gtest/gtest.h"
+
+#include "test_helpers.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr auto cell_size = 10.0F;
+
+game_engine::material_t make_material(float shininess) {
+    game_engine::material_t ret;
+    ret.m_ambient = glm::vec3(0.5F);
+    ret.m_shininess = shininess;
+    return ret;
+}
+
+TEST(static_groups_test, is_same_material) {
+    const auto material = make_material(32.0F);
+    EXPECT_TRUE(game_engine::is_same_material(material, material));
+
+    auto other = material;
+    other.m_ambient.y = 0.25F;
+    EXPECT_FALSE(game_engine::is_same_material(material, other));
+    other = material;
+    other.m_shininess = 64.0F;
+    EXPECT_FALSE(game_engine::is_same_material(material, other));
+    other = material;
+    other.m_texture2_layer = 1;
+    EXPECT_FALSE(game_engine::is_same_material(material, other));
+    other = material;
+    other.m_texture_mix = 0.5F;
+    EXPECT_FALSE(game_engine::is_same_material(material, other));
+}
+
+TEST(static_groups_test, groups_by_material_and_cell) {
+    const auto first = make_material(32.0F);
+    const auto second = make_material(64.0F);
+
+    // Two shapes of each material in the first cell, one of the first material in another.
+    const std::vector<game_engine::static_groups_t::member_t> members = {
+        {first, make_box(glm::vec3(1.0F), 1.0F), 36},
+        {second, make_box(glm::vec3(2.0F), 1.0F), 6},
+        {first, make_box(glm::vec3(25.0F, 1.0F, 1.0F), 1.0F), 12},
+        {first, make_box(glm::vec3(8.0F), 1.0F), 24},
+        {second, make_box(glm::vec3(5.0F), 3.0F), 3},
+    };
+    game_engine::static_groups_t groups(cell_size);
+    groups.build(members);
+
+    const auto &values = groups.get_groups();
+    ASSERT_EQ(values.size(), 3);
+    EXPECT_EQ(values[0].m_members, (std::vector<size_t>{0, 3}));
+    EXPECT_EQ(values[1].m_members, (std::vector<size_t>{1, 4}));
+    EXPECT_EQ(values[2].m_members, (std::vector<size_t>{2}));
+    EXPECT_TRUE(game_engine::is_same_material(values[1].m_material, second));
+    for (size_t member = 0; member < members.size(); ++member) {
+        const auto &group = values[groups.get_group(member)];
+        EXPECT_NE(std::find(group.m_members.begin(), group.m_members.end(), member), group.m_members.end());
+    }
+
+    // Bounds stay within the cells rather than spanning every shape of the material.
+    EXPECT_EQ(values[0].m_bounds.m_min, glm::vec3(0.0F));
+    EXPECT_EQ(values[0].m_bounds.m_max, glm::vec3(9.0F));
+    EXPECT_EQ(values[2].m_bounds.m_min, glm::vec3(24.0F, 0.0F, 0.0F));
+}
+
+TEST(static_groups_test, ranges_follow_each_other) {
+    const auto material = make_material(32.0F);
+    std::vector<game_engine::static_groups_t::member_t> members;
+    for (size_t i = 0; i < 20; ++i) {
+        members.push_back({material, make_box(glm::vec3(static_cast<float>(i % 4) * cell_size, 0.0F, 0.0F), 1.0F),
+                           3 * (i + 1)});
+    }
+    game_engine::static_groups_t groups(cell_size);
+    groups.build(members);
+
+    size_t first_vertex = 0;
+    for (const auto &group : groups.get_groups()) {
+        EXPECT_EQ(group.m_first_vertex, first_vertex);
+        size_t vertex_count = 0;
+        for (const auto member : group.m_members) {
+            vertex_count += members[member].m_vertex_count;
+        }
+        EXPECT_EQ(group.m_vertex_count, vertex_count);
+        first_vertex += vertex_count;
+    }
+    EXPECT_EQ(groups.get_groups().size(), 4);
+    EXPECT_EQ(groups.get_vertex_count(), first_vertex);
+    EXPECT_EQ(groups.get_vertex_count(), 3 * 20 * 21 / 2);
+
+    // Rebuilding replaces the groups.
+    groups.build({});
+    EXPECT_TRUE(groups.get_groups().empty());
+    EXPECT_EQ(groups.get_vertex_count(), 0);
+}
+
+} // namespace